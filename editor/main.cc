@@ -26,6 +26,7 @@
 #include <iostream>
 
 #include <spaghetti/editor.h>
+#include <spaghetti/node_registry.h>
 #include <spaghetti/registry.h>
 
 int main(int argc, char **argv)
@@ -54,6 +55,7 @@ int main(int argc, char **argv)
 
   auto &registry = spaghetti::Registry::get();
   registry.registerInternalElements();
+  spaghetti::NodeRegistry::get().registerInternalNodes();
   registry.loadPlugins();
   registry.loadPackages();
 
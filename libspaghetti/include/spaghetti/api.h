@@ -32,11 +32,18 @@
 #  else
 #   define SPAGHETTI_API __declspec(dllimport)
 #  endif
+#  if defined(SPAGHETTI_UI_EXPORTS)
+#   define SPAGHETTI_UI_API __declspec(dllexport)
+#  else
+#   define SPAGHETTI_UI_API __declspec(dllimport)
+#  endif
 # else
 #  define SPAGHETTI_API
+#  define SPAGHETTI_UI_API
 # endif
 #else
 # define SPAGHETTI_API __attribute__((visibility("default")))
+# define SPAGHETTI_UI_API __attribute__((visibility("default")))
 #endif
 // clang-format on
 
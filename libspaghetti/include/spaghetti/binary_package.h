@@ -0,0 +1,195 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_BINARY_PACKAGE_H
+#define SPAGHETTI_BINARY_PACKAGE_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <spaghetti/api.h>
+#include <spaghetti/vendor/json.hpp>
+
+namespace spaghetti {
+
+class MappedFile;
+
+// Compact alternative to the JSON .package format, meant to be mapped into memory and read in place.
+//
+// A file is a Header followed by arrays of fixed-layout records: interned strings, packages, elements,
+// sockets and connections, and a data block holding the string bytes and CBOR encoded element properties.
+// Element 0 is the saved package itself, package 0 its contents. Elements of one package are contiguous,
+// a nested package element points at its own PackageRecord. Anything an element writes besides the common
+// "element", "node" and "package" fields is kept as properties, so conversion to and from JSON is lossless.
+class SPAGHETTI_API BinaryPackage final {
+ public:
+  using Json = nlohmann::json;
+  using StringId = uint32_t;
+
+  static constexpr char const MAGIC[8]{ 'S', 'P', 'G', 'H', 'T', 'T', 'I', '\0' };
+  static constexpr uint32_t const VERSION{ 1 };
+  static constexpr uint32_t const BYTE_ORDER_MARK{ 0x01020304u };
+  static constexpr uint32_t const NONE{ std::numeric_limits<uint32_t>::max() };
+  static constexpr char const *const EXTENSION{ ".bpackage" };
+
+  struct Header {
+    char magic[8]{};
+    uint32_t version{};
+    uint32_t byteOrder{};
+    uint32_t stringCount{};
+    uint32_t packageCount{};
+    uint32_t elementCount{};
+    uint32_t socketCount{};
+    uint32_t connectionCount{};
+    uint32_t reserved{};
+    uint64_t stringsOffset{};
+    uint64_t packagesOffset{};
+    uint64_t elementsOffset{};
+    uint64_t socketsOffset{};
+    uint64_t connectionsOffset{};
+    uint64_t dataOffset{};
+    uint64_t dataSize{};
+  };
+
+  struct StringRecord {
+    uint64_t offset{};
+    uint32_t size{};
+    uint32_t reserved{};
+  };
+
+  struct PackageRecord {
+    enum Flags : uint32_t { eHasContent = 1 << 0 };
+
+    double inputsPosition[2]{};
+    double outputsPosition[2]{};
+    StringId description{ NONE };
+    StringId path{ NONE };
+    StringId icon{ NONE };
+    uint32_t flags{};
+    uint32_t firstElement{};
+    uint32_t elementCount{};
+    uint32_t firstConnection{};
+    uint32_t connectionCount{};
+  };
+
+  struct ElementRecord {
+    enum Flags : uint8_t {
+      eRotate = 1 << 0,
+      eInvertH = 1 << 1,
+      eIconify = 1 << 2,
+      eIconifyingHidesCentralWidget = 1 << 3,
+      eHasRotate = 1 << 4,
+      eHasInvertH = 1 << 5
+    };
+
+    uint64_t id{};
+    double position[2]{};
+    uint64_t propertiesOffset{};
+    uint32_t propertiesSize{};
+    StringId type{ NONE };
+    StringId name{ NONE };
+    StringId description{ NONE };
+    uint32_t package{ NONE };
+    uint32_t firstSocket{};
+    uint16_t inputCount{};
+    uint16_t outputCount{};
+    uint8_t minInputs{};
+    uint8_t maxInputs{};
+    uint8_t minOutputs{};
+    uint8_t maxOutputs{};
+    uint8_t defaultNewInputFlags{};
+    uint8_t defaultNewOutputFlags{};
+    uint8_t flags{};
+    uint8_t reserved[5]{};
+  };
+
+  struct SocketRecord {
+    StringId name{ NONE };
+    StringId itemType{ NONE };
+    uint8_t type{};
+    uint8_t flags{};
+    uint8_t inFlags{};
+    uint8_t reserved{};
+  };
+
+  struct ConnectionRecord {
+    enum Flags : uint8_t { eHasFromFlags = 1 << 0, eHasToFlags = 1 << 1 };
+
+    uint64_t fromId{};
+    uint64_t toId{};
+    uint8_t fromSocket{};
+    uint8_t fromFlags{};
+    uint8_t toSocket{};
+    uint8_t toFlags{};
+    uint8_t flags{};
+    uint8_t reserved[3]{};
+  };
+
+  explicit BinaryPackage(std::string const &a_filename);
+  // Compiles a JSON package in memory, a_name is only used for logging.
+  BinaryPackage(Json const &a_json, std::string const &a_name);
+  ~BinaryPackage();
+
+  static bool isBinary(std::string const &a_filename);
+  static bool write(Json const &a_json, std::string const &a_filename);
+
+  bool isValid() const { return m_header != nullptr; }
+
+  Json toJson() const { return elementToJson(0); }
+  Json elementToJson(uint32_t const a_element) const;
+
+  std::string_view string(StringId const a_id) const;
+  char const *c_str(StringId const a_id) const;
+
+  Header const &header() const { return *m_header; }
+  PackageRecord const &package(uint32_t const a_index) const { return m_packages[a_index]; }
+  ElementRecord const &element(uint32_t const a_index) const { return m_elements[a_index]; }
+  SocketRecord const &socket(uint32_t const a_index) const { return m_sockets[a_index]; }
+  ConnectionRecord const &connection(uint32_t const a_index) const { return m_connections[a_index]; }
+
+ private:
+  void map(char const *const a_data, size_t const a_size);
+  bool validate() const;
+  bool validateStructure() const;
+
+ private:
+  std::string m_filename{};
+  std::unique_ptr<MappedFile> m_file{};
+  std::vector<char> m_bytes{}; // Backs packages compiled in memory, operator new aligns it enough for the records.
+  size_t m_size{};
+  Header const *m_header{};
+  StringRecord const *m_strings{};
+  PackageRecord const *m_packages{};
+  ElementRecord const *m_elements{};
+  SocketRecord const *m_sockets{};
+  ConnectionRecord const *m_connections{};
+  char const *m_data{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_BINARY_PACKAGE_H
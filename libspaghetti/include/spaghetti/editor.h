@@ -43,7 +43,7 @@ namespace spaghetti {
 class Package;
 class PackageView;
 
-class SPAGHETTI_API Editor /*final*/ : public QMainWindow {
+class SPAGHETTI_UI_API Editor /*final*/ : public QMainWindow {
   Q_OBJECT
 
  public:
@@ -31,8 +31,10 @@
 #endif
 // clang-format on
 
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <thread>
@@ -42,13 +44,14 @@
 #include <spaghetti/vendor/json.hpp>
 
 #include <spaghetti/api.h>
+#include <spaghetti/signal_store.h>
 #include <spaghetti/strings.h>
 
 namespace spaghetti {
 
+class BinaryPackage;
 class Package;
 
-enum class ValueType { eBool, eInt, eFloat, eByte, eWord64 };//IoType
 enum class SocketItemType { eInput, eOutput, eDynamic };//SiType
 enum class IOSocketsType { eInputs, eOutputs, eTop, eDown};//IoSide
 enum class EOrientation { eRight, eLeft, eUp, eDown };//TBD
@@ -119,7 +122,9 @@ class SPAGHETTI_API Element {
       eCanHoldAllValues = eCanHoldBool | eCanHoldInt | eCanHoldFloat | eCanHoldByte | eCanHoldWord64,
       eDefaultFlags = eCanHoldAllValues | eCanChangeName
     };
-    Value value{};
+    SignalStore *store{};
+    SignalStore::Handle handle{};
+    SignalStore::Handle storage{}; // Own slot, handle may alias the driving output's one.
     ValueType type{};
 
     size_t id{};
@@ -129,12 +134,26 @@ class SPAGHETTI_API Element {
     std::string name{};
 
     SocketItemType sItemType{};
+
+    template<typename T>
+    T get() const
+    {
+      return store->get<T>(handle);
+    }
+    template<typename T>
+    void set(T const a_value)
+    {
+      store->set(handle, a_value);
+    }
+
+    Value value() const;
+    void setValue(Value const &a_value);
   };
 
   using IOSockets = std::vector<IOSocket>;
 
-  Element() = default;
-  virtual ~Element() = default;
+  Element();
+  virtual ~Element();
 
 
 
@@ -149,12 +168,19 @@ class SPAGHETTI_API Element {
   virtual void serialize(Json &a_json);
   virtual void deserialize(Json const &a_json);
   virtual void deserialize(Json const &a_json, const bool isRootPackage);
+  // Same as deserialize() but straight from a binary package record. Elements with own state store it as
+  // "properties", those are always loaded through deserialize().
+  virtual void restore(BinaryPackage const &a_file, uint32_t const a_element);
 
   virtual void calculate() {}
   virtual void reset() {}
 
   virtual void update(duration_t const &a_delta) { (void)a_delta; }
 
+  void markDirty() { m_dirty = true; }
+  bool isDirty() const { return m_dirty; }
+  bool isTimeDriven() const { return m_timeDriven; }
+
   size_t id() const noexcept { return m_id; }
 
   void setName(std::string const &a_name);
@@ -218,6 +244,22 @@ class SPAGHETTI_API Element {
 
   void resetIOSocketValue(IOSocket &a_io);
 
+  SignalStore &signals();
+
+  // Elements constructed while a scope is alive keep their sockets in its store until they join a package,
+  // so only elements living on their own ever need a store of their own.
+  class SPAGHETTI_API SignalScope final {
+   public:
+    explicit SignalScope(SignalStore &a_store);
+    ~SignalScope();
+
+    SignalScope(SignalScope const &) = delete;
+    SignalScope &operator=(SignalScope const &) = delete;
+
+   private:
+    SignalStore *m_previous{};
+  };
+
   void setNode(void *const a_node) { m_node = a_node; }
 
   EOrientation orientation(){
@@ -255,6 +297,10 @@ class SPAGHETTI_API Element {
   void setMinOutputs(uint8_t const a_min);
   void setMaxOutputs(uint8_t const a_max);
   void setDefaultNewOutputFlags(uint8_t const a_flags) { m_defaultNewOutputFlags = a_flags; }
+
+  void setTimeDriven(bool const a_timeDriven) { m_timeDriven = a_timeDriven; }
+
+  virtual void bindSignals(SignalStore &a_store);
   Package *m_package{};
  protected:
   IOSockets m_inputs{};
@@ -280,6 +326,10 @@ class SPAGHETTI_API Element {
   uint8_t m_defaultNewOutputFlags{};
   EventCallback m_handler{};
   void *m_node{};
+  std::atomic_bool m_dirty{ true };
+  bool m_timeDriven{};
+  SignalStore *m_scopeSignals{};
+  std::unique_ptr<SignalStore> m_signals{};
 };
 
 template<typename T>
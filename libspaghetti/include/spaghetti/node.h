@@ -30,6 +30,7 @@
 
 #include <spaghetti/api.h>
 #include <spaghetti/element.h>
+#include <spaghetti/snapshot_buffer.h>
 #include <spaghetti/socket_item.h>
 
 class QTableWidget;
@@ -52,7 +53,7 @@ inline QString ValueType_to_QString(ValueType const a_type)
   return "Unknown";
 }
 
-class SPAGHETTI_API Node : public QGraphicsItem {
+class SPAGHETTI_UI_API Node : public QGraphicsItem {
  public:
   using Sockets = QVector<SocketItem *>;
 
@@ -101,6 +102,19 @@ class SPAGHETTI_API Node : public QGraphicsItem {
 
   Element *element() const { return m_element; }
 
+  // Value of a socket as of the last tick published to this node's view, never the live one. The socket's
+  // handle gets rebound by the dispatch thread, so it is resolved through the snapshot's own layout.
+  template<typename T>
+  T signal(Element::IOSocket const &a_socket) const
+  {
+    auto const SNAPSHOT = snapshot();
+    if (!SNAPSHOT) return T{};
+
+    auto const HANDLE = SNAPSHOT->resolve(a_socket.storage);
+    if (!SNAPSHOT->signals.contains(HANDLE)) return T{};
+    return SNAPSHOT->signals.get<T>(HANDLE);
+  }
+
   Sockets const &inputs() const { return m_inputs; }
   Sockets const &outputs() const { return m_outputs; }
 
@@ -110,6 +124,8 @@ class SPAGHETTI_API Node : public QGraphicsItem {
   void paintIcon(QPainter *const a_painter);
 
   virtual void showProperties();
+  // Picks up the latest snapshot, the view only asks nodes whose signals changed since the last frame.
+  void refreshSignals();
   virtual void refreshCentralWidget() {}
   virtual void elementSet() {}
   virtual void handleEvent(Event const &a_event);
@@ -145,6 +161,7 @@ class SPAGHETTI_API Node : public QGraphicsItem {
   void setOutputName(uint8_t const a_socketId, QString const &a_name);
 
   void updateOutputs();
+  SnapshotBuffer::Snapshot const *snapshot() const;
 
  protected:
   QGraphicsItem *m_centralWidget{};
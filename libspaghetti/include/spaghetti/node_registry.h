@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_NODE_REGISTRY_H
+#define SPAGHETTI_NODE_REGISTRY_H
+
+// clang-format off
+#ifdef _MSC_VER
+# pragma warning(disable:4251)
+#endif
+// clang-format on
+
+#include <cassert>
+#include <type_traits>
+#include <unordered_map>
+
+#include <spaghetti/api.h>
+#include <spaghetti/element.h>
+#include <spaghetti/strings.h>
+
+namespace spaghetti {
+
+class Node;
+
+// Maps element types to the nodes representing them in the editor. It lives in the UI library so the
+// simulation core and its Registry stay free of Qt; elements without a registered node get a plain Node.
+class SPAGHETTI_UI_API NodeRegistry {
+ public:
+  static NodeRegistry &get();
+
+  void registerInternalNodes();
+
+  template<typename ElementDerived, typename NodeDerived>
+  typename std::enable_if_t<(std::is_base_of_v<Element, ElementDerived> && std::is_base_of_v<Node, NodeDerived>)>
+  registerNode()
+  {
+    string::hash_t const hash{ ElementDerived::HASH };
+    assert(!hasNode(hash));
+    m_nodes[hash] = &cloneNode<NodeDerived>;
+  }
+
+  Node *createNode(char const *const a_name) { return createNode(string::hash(a_name)); }
+  Node *createNode(string::hash_t const a_hash);
+
+  bool hasNode(string::hash_t const a_hash) const;
+
+ private:
+  NodeRegistry() = default;
+
+  template<typename T>
+  static Node *cloneNode()
+  {
+    return new T;
+  }
+
+ private:
+  using CloneFunc = Node *(*)();
+  std::unordered_map<string::hash_t, CloneFunc> m_nodes{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_NODE_REGISTRY_H
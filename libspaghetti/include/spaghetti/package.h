@@ -25,32 +25,26 @@
 #define SPAGHETTI_PACKAGE_H
 
 #include <atomic>
-
-// clang-format off
-#ifdef _MSC_VER
-# include <unordered_map>
-#else
-# include <spaghetti/vendor/sparsepp/spp.h>
-#endif
-// clang-format on
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <spaghetti/api.h>
 #include <spaghetti/element.h>
 #include <spaghetti/strings.h>
 #include <spaghetti/registry.h>
-
-// clang-format off
-#define PACKAGE_SPP_MAP 1
-#define PACKAGE_STD_UNORDERED_MAP 2
-#ifdef _MSC_VER
-# define PACKAGE_MAP PACKAGE_STD_UNORDERED_MAP
-#else
-# define PACKAGE_MAP PACKAGE_SPP_MAP
-#endif
-// clang-format on
+#include <spaghetti/snapshot_buffer.h>
 
 namespace spaghetti {
 
+class Arena;
+class EditQueue;
+class PackageBuilder;
+class WorkerPool;
+
 class SPAGHETTI_API Package final : public Element {
  public:
   using Elements = std::vector<Element *>;
@@ -65,6 +59,16 @@ class SPAGHETTI_API Package final : public Element {
 
   using Connections = std::vector<Connection>;
 
+  // Names an element slot, it goes stale once the element is removed, even if the slot gets reused.
+  struct Handle {
+    size_t id{};
+    uint32_t generation{};
+  };
+
+  enum class EvaluationMode { eEveryTick, eDirtyOnly };
+
+  using Edit = std::function<void()>;
+
   Package();
   ~Package() override;
 
@@ -78,6 +82,7 @@ class SPAGHETTI_API Package final : public Element {
 
   void serialize(Json &a_json) override;
   void deserialize(Json const &a_json) override;
+  void restore(BinaryPackage const &a_file, uint32_t const a_element) override;
 
   void calculate() override;
   void update(duration_t const &a_delta) override { m_delta = a_delta; }
@@ -97,14 +102,46 @@ class SPAGHETTI_API Package final : public Element {
   void remove(Element *const a_element) { remove(a_element->id()); }
   void remove(size_t const a_id);
 
+  std::vector<Element *> add(std::vector<string::hash_t> const &a_hashes);
+  void remove(std::vector<size_t> const &a_ids);
+
+  // Makes room for that many more elements and connections, so batches don't grow storage one by one.
+  void reserve(size_t const a_elements, size_t const a_connections);
+
   Element *get(size_t const a_id) const;
+  Element *get(Handle const a_handle) const;
+  Handle handle(size_t const a_id) const;
+  bool contains(size_t const a_id) const { return a_id < m_slots.size() && m_slots[a_id].element; }
+
+  // Renumbers elements so ids are dense again, ids and handles taken before may go stale.
+  void compact();
 
   bool connect(size_t const a_sourceId, uint8_t const a_sourceSocket, uint8_t const a_sourceFlags, size_t const a_targetId,
                uint8_t const a_targetSocket, uint8_t const a_targetFlags);
   bool disconnect(size_t const a_sourceId, uint8_t const a_outputId,  uint8_t const a_outputFlags, size_t const a_targetId, uint8_t const a_inputId, uint8_t const a_inputFlags);
 
+  void connect(Connections const &a_connections);
+  void disconnect(Connections const &a_connections);
+
+  // Connections leaving or entering one socket, id 0 standing for this package's own inputs or outputs.
+  Connections connectionsFrom(size_t const a_id, uint8_t const a_socket) const;
+  Connections connectionsTo(size_t const a_id, uint8_t const a_socket) const;
+
+  // Graph edits run between ticks on the thread driving them. post() only enqueues, apply() waits until the
+  // edit is done and runs it in place only on the dispatch thread, before it starts, or on the thread that
+  // paused it.
+  void post(Edit a_edit);
+  void apply(Edit const &a_edit);
+
   void dispatchThreadFunction();
 
+  void setTickInterval(std::chrono::nanoseconds const a_interval);
+  std::chrono::nanoseconds tickInterval() const { return m_tickInterval; }
+  bool isFreeRunning() const { return m_tickInterval.load().count() == 0; }
+  uint64_t ticks() const { return m_ticks; }
+  uint64_t overruns() const { return m_overruns; }
+  uint64_t missedTicks() const { return m_missedTicks; }
+
   void startDispatchThread();
   void quitDispatchThread();
   void pauseDispatchThread();
@@ -114,18 +151,128 @@ class SPAGHETTI_API Package final : public Element {
   void setInputsPosition(vec2d const a_position) { m_inputsPosition = a_position; }
   vec2d const &inputsPosition() const { return m_inputsPosition; }
 
+  void setEvaluationMode(EvaluationMode const a_mode);
+  EvaluationMode evaluationMode() const { return m_evaluationMode; }
+
+  void setZeroCopyConnections(bool const a_enabled);
+  bool zeroCopyConnections() const { return m_zeroCopyConnections; }
+
+  // Inlines nested packages into this package's schedule, their boundary sockets only forward what drives them.
+  void setFlattenPackages(bool const a_enabled);
+  bool flattenPackages() const { return m_flattenPackages; }
+
+  void setWorkerThreads(size_t const a_count);
+  size_t workerThreads() const;
+
+  void invalidateSchedule();
+
+  std::shared_ptr<SnapshotBuffer> subscribeSnapshots();
+  void unsubscribeSnapshots(std::shared_ptr<SnapshotBuffer> const &a_buffer);
+  void publishSnapshots();
+
   void setOutputsPosition(double const a_x, double const a_y);
   void setOutputsPosition(vec2d const a_position) { m_outputsPosition = a_position; }
   vec2d const &outputsPosition() const { return m_outputsPosition; }
 
+  // Every element of the package except the package itself, densely packed in no particular order.
   Elements const &elements() const { return m_elements; }
   Connections const &connections() const { return m_connections; }
 
-  void open(std::string const &a_filename);
+  // Returns false when the file can't be read or a binary package fails validation.
+  bool open(std::string const &a_filename);
   void save(std::string const &a_filename);
 
   static Registry::PackageInfo getInfoFor(std::string const &a_filename);
 
+ private:
+  struct Copy {
+    Element *source{};
+    Element *target{};
+    uint8_t sourceSocket{};
+    uint8_t targetSocket{};
+    bool sourceIsOutput{};
+    bool targetIsOutput{};
+  };
+  using Copies = std::vector<Copy>;
+
+  struct Step {
+    Element *element{};
+    size_t copiesBegin{};
+    size_t copiesEnd{};
+    size_t dependentsBegin{};
+    size_t dependentsEnd{};
+    std::vector<Value> published{};
+  };
+  using Steps = std::vector<Step>;
+
+  struct Level {
+    size_t stepsBegin{};
+    size_t stepsEnd{};
+    bool parallel{};
+  };
+  using Levels = std::vector<Level>;
+
+  struct Slot {
+    Element *element{};
+    uint32_t generation{};
+    uint32_t dense{};
+  };
+
+  struct Alias {
+    Element *element{};
+    uint8_t socket{};
+    bool isOutput{};
+  };
+
+  void bindSignals(SignalStore &a_store) override;
+
+  friend class Element;
+  friend class PackageBuilder;
+
+  using RemappedIds = std::map<size_t, size_t>;
+
+  void deserializeHeader(Json const &a_json);
+  void loadElement(Json const &a_element, RemappedIds &a_remappedIds);
+  void loadContent(Json const &a_package, RemappedIds &a_remappedIds);
+  void loadContent(BinaryPackage const &a_file, uint32_t const a_package);
+  void loadExternal(std::string const &a_path);
+
+  // Connections of every used socket, each connection knows where it sits in both of its lists.
+  using ConnectionIndex = std::unordered_map<uint64_t, std::vector<size_t>>;
+  struct ConnectionPositions {
+    size_t bySource{};
+    size_t byTarget{};
+  };
+
+  static uint64_t socketKey(size_t const a_id, uint8_t const a_socket)
+  {
+    return static_cast<uint64_t>(a_id) << 8 | a_socket;
+  }
+  void addConnection(Connection const &a_connection);
+  void removeConnection(size_t const a_index);
+  // Drops the connections of a socket about to go away, id 0 meaning the package's own sockets.
+  void unlinkSocket(size_t const a_id, uint8_t const a_socket, bool const a_input);
+  void unlink(std::vector<size_t> &a_connections);
+  void indexConnections();
+
+  void insert(Element *const a_element);
+  void link(Connection const &a_connection);
+  void destroy(Element *const a_element);
+  void applyEdits();
+  bool isDispatchThread() const;
+  bool isPauseOwner() const;
+  void collectGraph(Elements &a_nodes, Copies &a_copies) const;
+  void compileSchedule();
+  static void sleepUntil(std::chrono::steady_clock::time_point const &a_deadline);
+  void runStep(Step &a_step, bool const a_dirtyOnly);
+  bool alias(Copy const &a_copy);
+  bool forward(Copy const &a_copy);
+  void restoreAliases();
+  void collectAliases(SnapshotBuffer::Aliases &a_aliases) const;
+  static void copy(Copy const &a_copy);
+  static bool publish(std::vector<Value> &a_published, IOSockets const &a_sockets);
+  void markDependentsDirty(size_t const a_begin, size_t const a_end);
+
  private:
   duration_t m_delta{};
   std::string m_packageDescription{ "A package" };
@@ -133,24 +280,49 @@ class SPAGHETTI_API Package final : public Element {
   std::string m_packageIcon{ ":/unknown.png" };
   vec2d m_inputsPosition{ -400.0, 0.0 };
   vec2d m_outputsPosition{ 400.0, 0.0 };
+  std::unique_ptr<Arena> m_arena{};
+  std::vector<Slot> m_slots{};
   Elements m_elements{};
   Connections m_connections{};
+  ConnectionIndex m_connectionsBySource{};
+  ConnectionIndex m_connectionsByTarget{};
+  std::vector<ConnectionPositions> m_connectionPositions{};
 
   std::vector<size_t> m_free{};
 
-#if PACKAGE_MAP == PACKAGE_SPP_MAP
-  using Callbacks = spp::sparse_hash_map<size_t, std::vector<size_t>>;
-#elif PACKAGE_MAP == PACKAGE_STD_UNORDERED_MAP
-  using Callbacks = std::unordered_map<size_t, std::vector<size_t>>;
-#endif
+  Steps m_steps{};
+  Levels m_levels{};
+  Copies m_copies{};
+  Copies m_feedbackCopies{};
+  Copies m_outputCopies{};
+  Elements m_dependents{};
+  size_t m_inputDependents{};
+  std::vector<Alias> m_aliases{};
+  bool m_scheduleDirty{ true };
+  EvaluationMode m_evaluationMode{ EvaluationMode::eEveryTick };
+  bool m_zeroCopyConnections{};
+  bool m_flattenPackages{};
+  std::unique_ptr<WorkerPool> m_workers{};
+  std::unique_ptr<EditQueue> m_edits{};
+  std::vector<Value> m_publishedInputs{};
+  std::vector<std::shared_ptr<SnapshotBuffer>> m_snapshotBuffers{};
+  std::atomic_uint64_t m_layout{};
+  std::shared_ptr<SnapshotBuffer::Aliases const> m_publishedAliases{};
+  uint64_t m_publishedLayout{};
 
-  Callbacks m_dependencies{};
   std::thread m_dispatchThread{};
   std::atomic_bool m_dispatchThreadStarted{};
   std::atomic_bool m_quit{};
   std::atomic_bool m_pause{};
   std::atomic_bool m_paused{};
+  std::atomic<std::thread::id> m_pauseOwner{};
   std::atomic_uint32_t m_pauseCount{};
+  std::mutex m_pauseMutex{};
+  std::condition_variable m_pauseCondition{};
+  std::atomic<std::chrono::nanoseconds> m_tickInterval{ std::chrono::milliseconds(1) };
+  std::atomic_uint64_t m_ticks{};
+  std::atomic_uint64_t m_overruns{};
+  std::atomic_uint64_t m_missedTicks{};
   bool m_isExternal{};
 };
 
@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_PACKAGE_BUILDER_H
+#define SPAGHETTI_PACKAGE_BUILDER_H
+
+#include <string>
+#include <vector>
+
+#include <spaghetti/api.h>
+#include <spaghetti/package.h>
+
+namespace spaghetti {
+
+// Stages elements and connections for a package and commits them as a single edit. Until then elements
+// are named by references: PACKAGE is the package itself, use() brings in an existing element and add()
+// stages a new one.
+class SPAGHETTI_API PackageBuilder final {
+ public:
+  using Ref = size_t;
+  static constexpr Ref const PACKAGE{ 0 };
+
+  struct Link {
+    Ref source{};
+    uint8_t sourceSocket{};
+    Ref target{};
+    uint8_t targetSocket{};
+  };
+  using Links = std::vector<Link>;
+
+  explicit PackageBuilder(Package &a_package);
+
+  void reserve(size_t const a_elements, size_t const a_links);
+
+  Ref add(char const *const a_name) { return add(string::hash(a_name)); }
+  Ref add(string::hash_t const a_hash);
+  // References of a batch are consecutive, the first one is returned.
+  Ref add(std::vector<string::hash_t> const &a_hashes);
+  Ref use(size_t const a_id);
+
+  void connect(Ref const a_source, uint8_t const a_sourceSocket, Ref const a_target, uint8_t const a_targetSocket);
+  void connect(Links const &a_links);
+
+  // Validates the whole batch first and leaves the package untouched if anything is wrong.
+  bool commit();
+  std::string const &error() const { return m_error; }
+
+  // Element behind a reference, new elements only exist after a successful commit.
+  Element *element(Ref const a_ref) const;
+  size_t size() const { return m_entries.size(); }
+
+ private:
+  struct Entry {
+    string::hash_t hash{};
+    size_t id{};
+    Element *element{};
+  };
+
+  bool apply();
+  bool fail(std::string a_error);
+
+ private:
+  Package &m_package;
+  std::vector<Entry> m_entries{};
+  Links m_links{};
+  size_t m_added{};
+  std::string m_error{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_PACKAGE_BUILDER_H
@@ -31,18 +31,23 @@
 // clang-format on
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
 #include <unordered_map>
 #include <type_traits>
 
 #include <spaghetti/api.h>
 #include <spaghetti/strings.h>
+#include <spaghetti/vendor/json.hpp>
 
 namespace spaghetti {
 
+class Arena;
+class BinaryPackage;
 class Element;
-class Node;
+class SignalStore;
 
 class SPAGHETTI_API Registry  {
 protected: struct MetaInfo {
@@ -53,7 +58,10 @@ protected: struct MetaInfo {
     template<typename T>
     using CloneFunc = T *(*)();
     CloneFunc<Element> cloneElement{};
-    CloneFunc<Node> cloneNode{};
+    template<typename T>
+    using ConstructFunc = T *(*)(void *);
+    ConstructFunc<Element> constructElement{};
+    size_t size{};
   };
 
  public:
@@ -64,6 +72,13 @@ protected: struct MetaInfo {
   };
   using Packages = std::unordered_map<std::string, PackageInfo>;
 
+  // An external package file compiled once and shared by all of its instances until it changes on disk.
+  // JSON files are compiled into an in-memory BinaryPackage, so instances never walk a JSON tree.
+  struct PackageDefinition {
+    std::string filename{};
+    std::shared_ptr<BinaryPackage const> binary{};
+  };
+
   static Registry* m_instance1;
   static Registry &get() { return *m_instance1; }
   static void registrySet(Registry * reg){ m_instance1 = reg; }
@@ -80,26 +95,25 @@ protected: struct MetaInfo {
   void loadPlugins();
   void loadPackages();
 
-  template<typename ElementDerived, typename NodeDerived = Node>
-  typename std::enable_if_t<(std::is_base_of_v<Element, ElementDerived> && std::is_base_of_v<Node, NodeDerived>)>
+  template<typename ElementDerived>
+  typename std::enable_if_t<std::is_base_of_v<Element, ElementDerived>>
   registerElement(std::string a_name, std::string a_icon)
   {
+    static_assert(alignof(ElementDerived) <= alignof(std::max_align_t), "Elements have to fit package arenas");
     string::hash_t const hash{ ElementDerived::HASH };
-    assert(!hasElement(hash));
     MetaInfo info{ hash,
                    ElementDerived::TYPE,
                    std::move(a_name),
                    std::move(a_icon),
                    &cloneElement<ElementDerived>,
-                   &cloneNode<NodeDerived> };
+                   &constructElement<ElementDerived>,
+                   sizeof(ElementDerived) };
     addElement(info);
   }
 
   Element *createElement(char const *const a_name) { return createElement(string::hash(a_name)); }
   Element *createElement(string::hash_t const a_hash);
-
-  Node *createNode(char const *const a_name) { return createNode(string::hash(a_name)); }
-  Node *createNode(string::hash_t const a_hash);
+  Element *createElement(string::hash_t const a_hash, Arena &a_arena, SignalStore &a_signals);
 
   std::string elementName(char const *const a_name) { return elementName(string::hash(a_name)); }
   std::string elementName(string::hash_t const a_hash);
@@ -114,6 +128,9 @@ protected: struct MetaInfo {
   MetaInfo const &metaInfoAt(size_t const a_index) const;
 
   Packages const &packages() const;
+  std::shared_ptr<PackageDefinition const> packageDefinition(std::string const &a_path);
+  // Starts a load batch, cached definitions are checked against the disk once per batch.
+  void beginPackageBatch();
 
   std::string appPath() const;
   std::string systemPluginsPath() const;
@@ -134,9 +151,9 @@ protected: struct MetaInfo {
   }
 
   template<typename T>
-  static Node *cloneNode()
+  static Element *constructElement(void *const a_memory)
   {
-    return new T;
+    return new (a_memory) T;
   }
 
  private:
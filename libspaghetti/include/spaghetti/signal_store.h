@@ -0,0 +1,144 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_SIGNAL_STORE_H
+#define SPAGHETTI_SIGNAL_STORE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <spaghetti/api.h>
+
+namespace spaghetti {
+
+enum class ValueType { eBool, eInt, eFloat, eByte, eWord64 };//IoType
+
+// Current socket values kept per type in contiguous columns, sockets only hold a handle into them.
+class SPAGHETTI_API SignalStore {
+ public:
+  static constexpr uint32_t const INVALID_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+  struct Handle {
+    ValueType type{};
+    uint32_t index{ INVALID_INDEX };
+
+    bool isValid() const { return index != INVALID_INDEX; }
+    uint64_t key() const { return static_cast<uint64_t>(index) << 3 | static_cast<uint64_t>(type); }
+  };
+  using Changes = std::vector<Handle>;
+
+  template<typename T>
+  using Column = std::vector<T>;
+
+  Handle allocate(ValueType const a_type);
+  void release(Handle const a_handle);
+  void reset(Handle const a_handle);
+  void copy(Handle const a_from, Handle const a_to);
+
+  bool contains(Handle const a_handle) const;
+  void snapshotTo(SignalStore &a_target) const;
+  void snapshotTo(SignalStore &a_target, ValueType const a_type) const;
+  // Appends every signal whose value differs from a_seen and brings a_seen up to date on the way.
+  void collectChanges(SignalStore &a_seen, Changes &a_changes) const;
+
+  template<typename T>
+  T get(Handle const a_handle) const;
+  template<typename T>
+  void set(Handle const a_handle, T const a_value);
+
+  Column<uint8_t> &bools() { return m_bools; }
+  Column<int32_t> &ints() { return m_ints; }
+  Column<float> &floats() { return m_floats; }
+  Column<uint8_t> &bytes() { return m_bytes; }
+  Column<uint64_t> &words64() { return m_words64; }
+
+  size_t size() const;
+
+ private:
+  template<typename T>
+  static uint32_t allocate(Column<T> &a_column, std::vector<uint32_t> &a_free);
+  template<typename T>
+  static void collectChanges(Column<T> const &a_column, Column<T> &a_seen, ValueType const a_type, Changes &a_changes);
+
+  Column<uint8_t> m_bools{};
+  Column<int32_t> m_ints{};
+  Column<float> m_floats{};
+  Column<uint8_t> m_bytes{};
+  Column<uint64_t> m_words64{};
+
+  std::vector<uint32_t> m_free[5]{};
+};
+
+template<typename T>
+inline T SignalStore::get(Handle const a_handle) const
+{
+  assert(a_handle.isValid());
+
+  auto const INDEX = a_handle.index;
+
+  if constexpr (std::is_same_v<T, bool>) {
+    if (a_handle.type == ValueType::eBool) return m_bools[INDEX] != 0;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    if (a_handle.type == ValueType::eInt) return m_ints[INDEX];
+  } else if constexpr (std::is_same_v<T, float>) {
+    if (a_handle.type == ValueType::eFloat) return m_floats[INDEX];
+  } else if constexpr (std::is_same_v<T, uint8_t>) {
+    if (a_handle.type == ValueType::eByte) return m_bytes[INDEX];
+  } else if constexpr (std::is_same_v<T, uint64_t>) {
+    if (a_handle.type == ValueType::eWord64) return m_words64[INDEX];
+  }
+
+  switch (a_handle.type) {
+    case ValueType::eBool: return static_cast<T>(m_bools[INDEX] != 0);
+    case ValueType::eInt: return static_cast<T>(m_ints[INDEX]);
+    case ValueType::eFloat: return static_cast<T>(m_floats[INDEX]);
+    case ValueType::eByte: return static_cast<T>(m_bytes[INDEX]);
+    case ValueType::eWord64: return static_cast<T>(m_words64[INDEX]);
+  }
+
+  return T{};
+}
+
+template<typename T>
+inline void SignalStore::set(Handle const a_handle, T const a_value)
+{
+  assert(a_handle.isValid());
+
+  auto const INDEX = a_handle.index;
+
+  switch (a_handle.type) {
+    case ValueType::eBool: m_bools[INDEX] = static_cast<bool>(a_value); break;
+    case ValueType::eInt: m_ints[INDEX] = static_cast<int32_t>(a_value); break;
+    case ValueType::eFloat: m_floats[INDEX] = static_cast<float>(a_value); break;
+    case ValueType::eByte: m_bytes[INDEX] = static_cast<uint8_t>(a_value); break;
+    case ValueType::eWord64: m_words64[INDEX] = static_cast<uint64_t>(a_value); break;
+  }
+}
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_SIGNAL_STORE_H
@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_SNAPSHOT_BUFFER_H
+#define SPAGHETTI_SNAPSHOT_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <spaghetti/api.h>
+#include <spaghetti/signal_store.h>
+
+namespace spaghetti {
+
+// Lock-free triple buffer handing whole-tick copies of a SignalStore from the dispatch thread to one reader.
+// The writer fills back() and publishes it, the reader picks up the newest published copy with acquire();
+// neither side ever waits for the other and each buffer is owned by exactly one side at a time.
+// Publishing is only worth it once the reader has picked up the previous copy, see consumed().
+class SPAGHETTI_API SnapshotBuffer {
+ public:
+  // Signal each rebound socket reads, keyed by the key() of the socket's own storage.
+  using Aliases = std::unordered_map<uint64_t, SignalStore::Handle>;
+
+  struct Snapshot {
+    uint64_t tick{};
+    uint64_t layout{}; // Changes whenever sockets may have been bound to other signals.
+    SignalStore signals{};
+    SignalStore::Changes changes{}; // Everything changed since the snapshot the reader acquired before this one.
+    std::shared_ptr<Aliases const> aliases{}; // Shared by all snapshots of one layout.
+    uint64_t columns[5]{}; // Column versions held in signals, indexed by ValueType.
+
+    // Signal behind a socket's storage as of this snapshot's layout, readers never look at the live handle.
+    SignalStore::Handle resolve(SignalStore::Handle const a_storage) const
+    {
+      if (!aliases) return a_storage;
+      auto const IT = aliases->find(a_storage.key());
+      return IT != aliases->end() ? IT->second : a_storage;
+    }
+  };
+
+  Snapshot &back() { return m_buffers[m_back]; }
+  // Copies the columns of a_signals changed since back() was last written and hands it to the reader.
+  void publish(SignalStore const &a_signals);
+  bool consumed() const { return !(m_middle.load(std::memory_order_acquire) & FRESH); }
+
+  bool acquire();
+  Snapshot const &front() const { return m_buffers[m_front]; }
+
+ private:
+  static constexpr uint8_t const FRESH{ 1 << 2 };
+  static constexpr uint8_t const INDEX_MASK{ FRESH - 1 };
+
+  void mark(SignalStore::Changes const &a_changes);
+
+  Snapshot m_buffers[3]{};
+  SignalStore m_seen{};
+  SignalStore::Changes m_changes{};
+  uint64_t m_publishes{};
+  uint64_t m_columns[5]{};
+  SignalStore::Changes m_pending{};
+  std::vector<uint8_t> m_marked[5]{};
+  uint8_t m_back{ 0 };
+  alignas(64) std::atomic_uint8_t m_middle{ 1 };
+  alignas(64) uint8_t m_front{ 2 };
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_SNAPSHOT_BUFFER_H
@@ -26,6 +26,7 @@
 
 #include <QGraphicsItem>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QVector>
 
 #include <spaghetti/element.h>
@@ -37,6 +38,14 @@ class LinkItem;
 
 constexpr int SOCKET_TYPE{ QGraphicsItem::UserType + 3 };
 
+// Zoomed out below this level, items are drawn as plain shapes: no text, icons or decorations.
+constexpr qreal const LOW_DETAIL_LEVEL{ 0.5 };
+
+inline bool isLowDetail(QPainter const *const a_painter)
+{
+  return QStyleOptionGraphicsItem::levelOfDetailFromTransform(a_painter->worldTransform()) < LOW_DETAIL_LEVEL;
+}
+
 class SocketItem final : public QGraphicsItem {
  public:
   //enum class Type { eInput, eOutput, eDynamic };
@@ -102,6 +111,8 @@ class SocketItem final : public QGraphicsItem {
   void setValueType(ValueType const a_type);
   ValueType valueType() const { return m_valueType; }
 
+  void animateLinks();
+
  private:
   void removeLink(LinkItem *const a_linkItem);
   LinkItem *linkBetween(SocketItem *const a_from, SocketItem *const a_to) const;
@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "arena.h"
+
+#include <cassert>
+#include <new>
+
+namespace spaghetti {
+
+Arena::Arena(size_t const a_blockSize)
+  : m_blockSize{ roundUp(a_blockSize) }
+{
+  assert(m_blockSize > HEADER_SIZE);
+}
+
+void *Arena::allocate(size_t const a_size)
+{
+  size_t const SIZE{ HEADER_SIZE + roundUp(a_size) };
+
+  auto const RELEASED = m_released.find(SIZE);
+  if (RELEASED != m_released.end() && !RELEASED->second.empty()) {
+    auto const pointer = RELEASED->second.back();
+    RELEASED->second.pop_back();
+    return pointer;
+  }
+
+  std::byte *memory{};
+  if (SIZE > m_blockSize) {
+    m_oversized.push_back(std::make_unique<std::max_align_t[]>(SIZE / sizeof(std::max_align_t) + 1));
+    memory = reinterpret_cast<std::byte *>(m_oversized.back().get());
+  } else {
+    if (m_blocks.empty() || m_used + SIZE > m_blockSize) {
+      m_blocks.push_back(std::make_unique<std::max_align_t[]>(m_blockSize / sizeof(std::max_align_t)));
+      m_used = 0;
+    }
+    memory = reinterpret_cast<std::byte *>(m_blocks.back().get()) + m_used;
+    m_used += SIZE;
+  }
+
+  new (memory) Header{ SIZE };
+  return memory + HEADER_SIZE;
+}
+
+void Arena::release(void *const a_pointer)
+{
+  if (!a_pointer) return;
+
+  auto const HEADER = reinterpret_cast<Header const *>(static_cast<std::byte *>(a_pointer) - HEADER_SIZE);
+  m_released[HEADER->size].push_back(a_pointer);
+}
+
+} // namespace spaghetti
@@ -0,0 +1,66 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_ARENA_H
+#define SPAGHETTI_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace spaghetti {
+
+// Block allocator owning the elements of one package. Released memory is kept for the next allocation of
+// the same size and everything goes back to the system at once when the arena is destroyed.
+class Arena final {
+ public:
+  static constexpr size_t const ALIGNMENT{ alignof(std::max_align_t) };
+
+  explicit Arena(size_t const a_blockSize = 64 * 1024);
+
+  Arena(Arena const &) = delete;
+  Arena &operator=(Arena const &) = delete;
+
+  void *allocate(size_t const a_size);
+  void release(void *const a_pointer);
+
+ private:
+  struct Header {
+    size_t size{};
+  };
+  static constexpr size_t const HEADER_SIZE{ (sizeof(Header) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT };
+
+  static size_t roundUp(size_t const a_size) { return (a_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+ private:
+  size_t const m_blockSize{};
+  std::vector<std::unique_ptr<std::max_align_t[]>> m_blocks{};
+  std::vector<std::unique_ptr<std::max_align_t[]>> m_oversized{};
+  size_t m_used{};
+  std::map<size_t, std::vector<void *>> m_released{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_ARENA_H
@@ -0,0 +1,660 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spaghetti/binary_package.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+#include "spaghetti/logger.h"
+#include "spaghetti/signal_store.h"
+#include "mapped_file.h"
+
+namespace spaghetti {
+
+static_assert(sizeof(BinaryPackage::Header) == 96);
+static_assert(sizeof(BinaryPackage::StringRecord) == 16);
+static_assert(sizeof(BinaryPackage::PackageRecord) == 64);
+static_assert(sizeof(BinaryPackage::ElementRecord) == 72);
+static_assert(sizeof(BinaryPackage::SocketRecord) == 12);
+static_assert(sizeof(BinaryPackage::ConnectionRecord) == 24);
+
+namespace {
+
+using Json = BinaryPackage::Json;
+using StringId = BinaryPackage::StringId;
+
+constexpr uint32_t const NONE{ BinaryPackage::NONE };
+
+// Fields the records hold, everything else an element writes goes to its properties.
+using Keys = std::initializer_list<char const *>;
+Keys const ELEMENT_KEYS{ "id",
+                         "name",
+                         "description",
+                         "type",
+                         "rotate",
+                         "invertH",
+                         "min_inputs",
+                         "max_inputs",
+                         "min_outputs",
+                         "max_outputs",
+                         "default_new_input_flags",
+                         "default_new_output_flags",
+                         "io" };
+Keys const NODE_KEYS{ "position", "iconify", "iconifying_hides_central_widget" };
+Keys const PACKAGE_NODE_KEYS{ "inputs_position", "outputs_position" };
+Keys const PACKAGE_KEYS{ "description", "path", "icon", "elements", "connections" };
+
+// Indexed by ValueType.
+char const *const SOCKET_TYPES[]{ "bool", "int", "float", "byte", "word64" };
+static_assert(std::size(SOCKET_TYPES) == static_cast<size_t>(ValueType::eWord64) + 1);
+
+constexpr uint64_t align(uint64_t const a_offset)
+{
+  return (a_offset + 7) & ~uint64_t{ 7 };
+}
+
+bool isKnown(Keys const &a_keys, std::string const &a_key)
+{
+  for (auto const KEY : a_keys)
+    if (a_key == KEY) return true;
+  return false;
+}
+
+Json const &member(Json const &a_object, char const *const a_key)
+{
+  static Json const EMPTY = Json::object();
+  if (!a_object.is_object()) return EMPTY;
+  auto const IT = a_object.find(a_key);
+  return IT == a_object.end() ? EMPTY : *IT;
+}
+
+template<typename T>
+T number(Json const &a_object, char const *const a_key)
+{
+  auto const &VALUE = member(a_object, a_key);
+  return VALUE.is_number() ? VALUE.get<T>() : T{};
+}
+
+bool flag(Json const &a_object, char const *const a_key)
+{
+  auto const &VALUE = member(a_object, a_key);
+  return VALUE.is_boolean() && VALUE.get<bool>();
+}
+
+class Writer {
+ public:
+  bool build(Json const &a_json, std::string const &a_name, std::vector<char> &a_bytes);
+
+ private:
+  StringId intern(std::string const &a_string);
+  StringId optionalString(Json const &a_object, char const *const a_key);
+  void addElement(uint32_t const a_index, Json const &a_json);
+  uint32_t addPackage(Json const &a_json);
+  void addSocket(Json const &a_socket);
+  void addProperties(BinaryPackage::ElementRecord &a_record, Json const &a_json, bool const a_isPackage);
+
+ private:
+  std::vector<BinaryPackage::StringRecord> m_strings{};
+  std::vector<BinaryPackage::PackageRecord> m_packages{};
+  std::vector<BinaryPackage::ElementRecord> m_elements{};
+  std::vector<BinaryPackage::SocketRecord> m_sockets{};
+  std::vector<BinaryPackage::ConnectionRecord> m_connections{};
+  std::vector<char> m_data{};
+  std::unordered_map<std::string, StringId> m_stringIds{};
+  bool m_failed{};
+};
+
+StringId Writer::intern(std::string const &a_string)
+{
+  auto const [IT, INSERTED] = m_stringIds.emplace(a_string, static_cast<StringId>(m_strings.size()));
+  if (INSERTED) {
+    m_strings.push_back({ m_data.size(), static_cast<uint32_t>(a_string.size()) });
+    m_data.insert(m_data.end(), a_string.begin(), a_string.end());
+    m_data.push_back('\0');
+  }
+  return IT->second;
+}
+
+StringId Writer::optionalString(Json const &a_object, char const *const a_key)
+{
+  auto const &VALUE = member(a_object, a_key);
+  return VALUE.is_string() ? intern(VALUE.get<std::string>()) : NONE;
+}
+
+void Writer::addSocket(Json const &a_socket)
+{
+  BinaryPackage::SocketRecord record{};
+  record.name = optionalString(a_socket, "name");
+  record.itemType = optionalString(a_socket, "siType");
+  record.flags = number<uint8_t>(a_socket, "flags");
+  record.inFlags = number<uint8_t>(a_socket, "inFlags");
+
+  auto const &TYPE = member(a_socket, "type");
+  auto const IT = std::find_if(std::begin(SOCKET_TYPES), std::end(SOCKET_TYPES),
+                               [&TYPE](char const *const a_type) { return TYPE.is_string() && TYPE == a_type; });
+  if (IT == std::end(SOCKET_TYPES)) {
+    log::error("[binary_package]: Unknown socket type {}", TYPE.dump());
+    m_failed = true;
+  } else
+    record.type = static_cast<uint8_t>(IT - std::begin(SOCKET_TYPES));
+
+  m_sockets.push_back(record);
+}
+
+void Writer::addProperties(BinaryPackage::ElementRecord &a_record, Json const &a_json, bool const a_isPackage)
+{
+  auto properties = Json::object();
+
+  for (auto IT = a_json.begin(); IT != a_json.end(); ++IT) {
+    Keys const *keys{};
+    if (IT.key() == "element")
+      keys = &ELEMENT_KEYS;
+    else if (IT.key() == "node")
+      keys = &NODE_KEYS;
+    else if (IT.key() == "package" && a_isPackage)
+      keys = &PACKAGE_KEYS;
+
+    if (keys == nullptr || !IT->is_object()) {
+      properties[IT.key()] = *IT;
+      continue;
+    }
+
+    for (auto FIELD = IT->begin(); FIELD != IT->end(); ++FIELD) {
+      if (isKnown(*keys, FIELD.key())) continue;
+      if (a_isPackage && keys == &NODE_KEYS && isKnown(PACKAGE_NODE_KEYS, FIELD.key())) continue;
+      properties[IT.key()][FIELD.key()] = *FIELD;
+    }
+  }
+
+  if (properties.empty()) return;
+
+  auto const CBOR = Json::to_cbor(properties);
+  a_record.propertiesOffset = m_data.size();
+  a_record.propertiesSize = static_cast<uint32_t>(CBOR.size());
+  m_data.insert(m_data.end(), CBOR.begin(), CBOR.end());
+}
+
+void Writer::addElement(uint32_t const a_index, Json const &a_json)
+{
+  auto const &ELEMENT = member(a_json, "element");
+  auto const &NODE = member(a_json, "node");
+  auto const &POSITION = member(NODE, "position");
+  auto const &IO = member(ELEMENT, "io");
+  auto const &INPUTS = member(IO, "inputs");
+  auto const &OUTPUTS = member(IO, "outputs");
+
+  BinaryPackage::ElementRecord record{};
+  record.id = number<uint64_t>(ELEMENT, "id");
+  record.position[0] = number<double>(POSITION, "x");
+  record.position[1] = number<double>(POSITION, "y");
+  record.type = optionalString(ELEMENT, "type");
+  record.name = optionalString(ELEMENT, "name");
+  record.description = optionalString(ELEMENT, "description");
+  record.minInputs = number<uint8_t>(ELEMENT, "min_inputs");
+  record.maxInputs = number<uint8_t>(ELEMENT, "max_inputs");
+  record.minOutputs = number<uint8_t>(ELEMENT, "min_outputs");
+  record.maxOutputs = number<uint8_t>(ELEMENT, "max_outputs");
+  record.defaultNewInputFlags = number<uint8_t>(ELEMENT, "default_new_input_flags");
+  record.defaultNewOutputFlags = number<uint8_t>(ELEMENT, "default_new_output_flags");
+
+  using Flags = BinaryPackage::ElementRecord::Flags;
+  if (member(ELEMENT, "rotate").is_boolean()) record.flags |= Flags::eHasRotate;
+  if (member(ELEMENT, "invertH").is_boolean()) record.flags |= Flags::eHasInvertH;
+  if (flag(ELEMENT, "rotate")) record.flags |= Flags::eRotate;
+  if (flag(ELEMENT, "invertH")) record.flags |= Flags::eInvertH;
+  if (flag(NODE, "iconify")) record.flags |= Flags::eIconify;
+  if (flag(NODE, "iconifying_hides_central_widget")) record.flags |= Flags::eIconifyingHidesCentralWidget;
+
+  constexpr size_t const MAX_SOCKETS{ std::numeric_limits<uint8_t>::max() };
+  if (INPUTS.size() > MAX_SOCKETS || OUTPUTS.size() > MAX_SOCKETS) {
+    log::error("[binary_package]: Element {} has more than {} inputs or outputs", record.id, MAX_SOCKETS);
+    m_failed = true;
+  }
+
+  record.firstSocket = static_cast<uint32_t>(m_sockets.size());
+  record.inputCount = static_cast<uint16_t>(INPUTS.size());
+  record.outputCount = static_cast<uint16_t>(OUTPUTS.size());
+  if (INPUTS.is_array())
+    for (auto const &SOCKET : INPUTS) addSocket(SOCKET);
+  if (OUTPUTS.is_array())
+    for (auto const &SOCKET : OUTPUTS) addSocket(SOCKET);
+
+  bool const IS_PACKAGE{ a_json.is_object() && a_json.find("package") != a_json.end() };
+  addProperties(record, a_json, IS_PACKAGE);
+
+  if (IS_PACKAGE) record.package = addPackage(a_json);
+
+  m_elements[a_index] = record;
+}
+
+uint32_t Writer::addPackage(Json const &a_json)
+{
+  auto const &NODE = member(a_json, "node");
+  auto const &INPUTS_POSITION = member(NODE, "inputs_position");
+  auto const &OUTPUTS_POSITION = member(NODE, "outputs_position");
+  auto const &PACKAGE = member(a_json, "package");
+  auto const &ELEMENTS = member(PACKAGE, "elements");
+  auto const &CONNECTIONS = member(PACKAGE, "connections");
+
+  // Reserve the slot first, nested packages are appended while walking the elements.
+  uint32_t const INDEX{ static_cast<uint32_t>(m_packages.size()) };
+  m_packages.emplace_back();
+
+  BinaryPackage::PackageRecord record{};
+  record.inputsPosition[0] = number<double>(INPUTS_POSITION, "x");
+  record.inputsPosition[1] = number<double>(INPUTS_POSITION, "y");
+  record.outputsPosition[0] = number<double>(OUTPUTS_POSITION, "x");
+  record.outputsPosition[1] = number<double>(OUTPUTS_POSITION, "y");
+  record.description = optionalString(PACKAGE, "description");
+  record.path = optionalString(PACKAGE, "path");
+  record.icon = optionalString(PACKAGE, "icon");
+
+  if (ELEMENTS.is_array() || CONNECTIONS.is_array()) record.flags |= BinaryPackage::PackageRecord::eHasContent;
+
+  record.firstElement = static_cast<uint32_t>(m_elements.size());
+  if (ELEMENTS.is_array()) {
+    record.elementCount = static_cast<uint32_t>(ELEMENTS.size());
+    m_elements.resize(m_elements.size() + ELEMENTS.size());
+    for (uint32_t i = 0; i < record.elementCount; ++i) addElement(record.firstElement + i, ELEMENTS[i]);
+  }
+
+  record.firstConnection = static_cast<uint32_t>(m_connections.size());
+  if (CONNECTIONS.is_array()) {
+    for (auto const &CONNECTION : CONNECTIONS) {
+      auto const &FROM = member(CONNECTION, "connect");
+      auto const &TO = member(CONNECTION, "to");
+
+      BinaryPackage::ConnectionRecord connection{};
+      connection.fromId = number<uint64_t>(FROM, "id");
+      connection.fromSocket = number<uint8_t>(FROM, "socket");
+      connection.fromFlags = number<uint8_t>(FROM, "flags");
+      connection.toId = number<uint64_t>(TO, "id");
+      connection.toSocket = number<uint8_t>(TO, "socket");
+      connection.toFlags = number<uint8_t>(TO, "flags");
+      if (member(FROM, "flags").is_number()) connection.flags |= BinaryPackage::ConnectionRecord::eHasFromFlags;
+      if (member(TO, "flags").is_number()) connection.flags |= BinaryPackage::ConnectionRecord::eHasToFlags;
+      m_connections.push_back(connection);
+    }
+    record.connectionCount = static_cast<uint32_t>(m_connections.size() - record.firstConnection);
+  }
+
+  m_packages[INDEX] = record;
+  return INDEX;
+}
+
+bool Writer::build(Json const &a_json, std::string const &a_name, std::vector<char> &a_bytes)
+{
+  if (member(a_json, "package").empty()) {
+    log::error("[binary_package]: {} is not a package", a_name);
+    return false;
+  }
+
+  m_elements.resize(1);
+  addElement(0, a_json);
+  if (m_failed) return false;
+
+  BinaryPackage::Header header{};
+  std::memcpy(header.magic, BinaryPackage::MAGIC, sizeof(header.magic));
+  header.version = BinaryPackage::VERSION;
+  header.byteOrder = BinaryPackage::BYTE_ORDER_MARK;
+  header.stringCount = static_cast<uint32_t>(m_strings.size());
+  header.packageCount = static_cast<uint32_t>(m_packages.size());
+  header.elementCount = static_cast<uint32_t>(m_elements.size());
+  header.socketCount = static_cast<uint32_t>(m_sockets.size());
+  header.connectionCount = static_cast<uint32_t>(m_connections.size());
+  header.stringsOffset = align(sizeof(header));
+  header.packagesOffset = align(header.stringsOffset + m_strings.size() * sizeof(m_strings[0]));
+  header.elementsOffset = align(header.packagesOffset + m_packages.size() * sizeof(m_packages[0]));
+  header.socketsOffset = align(header.elementsOffset + m_elements.size() * sizeof(m_elements[0]));
+  header.connectionsOffset = align(header.socketsOffset + m_sockets.size() * sizeof(m_sockets[0]));
+  header.dataOffset = align(header.connectionsOffset + m_connections.size() * sizeof(m_connections[0]));
+  header.dataSize = m_data.size();
+
+  // Zero filled, so the padding between sections stays deterministic.
+  a_bytes.assign(header.dataOffset + header.dataSize, '\0');
+  auto put = [&a_bytes](uint64_t const a_offset, void const *const a_data, size_t const a_size) {
+    if (a_size != 0) std::memcpy(a_bytes.data() + a_offset, a_data, a_size);
+  };
+
+  put(0, &header, sizeof(header));
+  put(header.stringsOffset, m_strings.data(), m_strings.size() * sizeof(m_strings[0]));
+  put(header.packagesOffset, m_packages.data(), m_packages.size() * sizeof(m_packages[0]));
+  put(header.elementsOffset, m_elements.data(), m_elements.size() * sizeof(m_elements[0]));
+  put(header.socketsOffset, m_sockets.data(), m_sockets.size() * sizeof(m_sockets[0]));
+  put(header.connectionsOffset, m_connections.data(), m_connections.size() * sizeof(m_connections[0]));
+  put(header.dataOffset, m_data.data(), m_data.size());
+
+  return true;
+}
+
+} // namespace
+
+BinaryPackage::BinaryPackage(std::string const &a_filename)
+  : m_filename{ a_filename }
+  , m_file{ std::make_unique<MappedFile>(a_filename) }
+{
+  if (m_file->isOpen()) map(m_file->data(), m_file->size());
+}
+
+BinaryPackage::BinaryPackage(Json const &a_json, std::string const &a_name)
+  : m_filename{ a_name }
+{
+  if (Writer{}.build(a_json, a_name, m_bytes)) map(m_bytes.data(), m_bytes.size());
+}
+
+void BinaryPackage::map(char const *const a_data, size_t const a_size)
+{
+  if (a_size < sizeof(Header)) return;
+
+  m_size = a_size;
+  auto const HEADER = reinterpret_cast<Header const *>(a_data);
+  if (std::memcmp(HEADER->magic, MAGIC, sizeof(MAGIC)) != 0) return;
+
+  if (HEADER->version != VERSION || HEADER->byteOrder != BYTE_ORDER_MARK) {
+    log::error("[binary_package]: {} has unsupported version {} or byte order", m_filename, HEADER->version);
+    return;
+  }
+
+  m_header = HEADER;
+  m_strings = reinterpret_cast<StringRecord const *>(a_data + HEADER->stringsOffset);
+  m_packages = reinterpret_cast<PackageRecord const *>(a_data + HEADER->packagesOffset);
+  m_elements = reinterpret_cast<ElementRecord const *>(a_data + HEADER->elementsOffset);
+  m_sockets = reinterpret_cast<SocketRecord const *>(a_data + HEADER->socketsOffset);
+  m_connections = reinterpret_cast<ConnectionRecord const *>(a_data + HEADER->connectionsOffset);
+  m_data = a_data + HEADER->dataOffset;
+
+  if (!validate()) {
+    log::error("[binary_package]: {} is corrupted", m_filename);
+    m_header = nullptr;
+  }
+}
+
+BinaryPackage::~BinaryPackage() = default;
+
+bool BinaryPackage::isBinary(std::string const &a_filename)
+{
+  std::ifstream file{ a_filename, std::ios::binary };
+  char magic[sizeof(MAGIC)]{};
+  return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool BinaryPackage::write(Json const &a_json, std::string const &a_filename)
+{
+  std::vector<char> bytes{};
+  if (!Writer{}.build(a_json, a_filename, bytes)) return false;
+
+  std::ofstream file{ a_filename, std::ios::binary };
+  if (!file.is_open()) {
+    log::error("[binary_package]: Can't write {}", a_filename);
+    return false;
+  }
+
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return file.good();
+}
+
+bool BinaryPackage::validate() const
+{
+  auto const &HEADER = *m_header;
+  uint64_t const SIZE{ m_size };
+
+  auto fits = [SIZE](uint64_t const a_offset, uint64_t const a_count, size_t const a_recordSize) {
+    return a_offset % 8 == 0 && a_offset <= SIZE && a_count <= (SIZE - a_offset) / a_recordSize;
+  };
+  if (!fits(HEADER.stringsOffset, HEADER.stringCount, sizeof(StringRecord)) ||
+      !fits(HEADER.packagesOffset, HEADER.packageCount, sizeof(PackageRecord)) ||
+      !fits(HEADER.elementsOffset, HEADER.elementCount, sizeof(ElementRecord)) ||
+      !fits(HEADER.socketsOffset, HEADER.socketCount, sizeof(SocketRecord)) ||
+      !fits(HEADER.connectionsOffset, HEADER.connectionCount, sizeof(ConnectionRecord)) ||
+      !fits(HEADER.dataOffset, HEADER.dataSize, 1))
+    return false;
+
+  if (HEADER.elementCount == 0 || m_elements[0].package == NONE) return false;
+
+  auto validString = [&HEADER](StringId const a_id) { return a_id == NONE || a_id < HEADER.stringCount; };
+  auto validRange = [](uint64_t const a_first, uint64_t const a_count, uint64_t const a_total) {
+    return a_first <= a_total && a_count <= a_total - a_first;
+  };
+
+  for (uint32_t i = 0; i < HEADER.stringCount; ++i) {
+    auto const &STRING = m_strings[i];
+    if (!validRange(STRING.offset, uint64_t{ STRING.size } + 1, HEADER.dataSize)) return false;
+    if (m_data[STRING.offset + STRING.size] != '\0') return false;
+  }
+
+  for (uint32_t i = 0; i < HEADER.packageCount; ++i) {
+    auto const &PACKAGE = m_packages[i];
+    if (!validString(PACKAGE.description) || !validString(PACKAGE.path) || !validString(PACKAGE.icon)) return false;
+    if (!validRange(PACKAGE.firstElement, PACKAGE.elementCount, HEADER.elementCount)) return false;
+    if (!validRange(PACKAGE.firstConnection, PACKAGE.connectionCount, HEADER.connectionCount)) return false;
+  }
+
+  for (uint32_t i = 0; i < HEADER.elementCount; ++i) {
+    auto const &ELEMENT = m_elements[i];
+    if (!validString(ELEMENT.type) || !validString(ELEMENT.name) || !validString(ELEMENT.description)) return false;
+    if (ELEMENT.package != NONE && ELEMENT.package >= HEADER.packageCount) return false;
+    if (!validRange(ELEMENT.firstSocket, uint64_t{ ELEMENT.inputCount } + ELEMENT.outputCount, HEADER.socketCount))
+      return false;
+    if (!validRange(ELEMENT.propertiesOffset, ELEMENT.propertiesSize, HEADER.dataSize)) return false;
+  }
+
+  // Properties are only decoded while restoring, a broken blob has to be caught before anything gets built.
+  for (uint32_t i = 0; i < HEADER.elementCount; ++i) {
+    auto const &ELEMENT = m_elements[i];
+    if (ELEMENT.propertiesSize == 0) continue;
+
+    try {
+      std::vector<uint8_t> const CBOR(m_data + ELEMENT.propertiesOffset,
+                                      m_data + ELEMENT.propertiesOffset + ELEMENT.propertiesSize);
+      if (!Json::from_cbor(CBOR).is_object()) return false;
+    } catch (Json::exception const &) {
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < HEADER.socketCount; ++i) {
+    auto const &SOCKET = m_sockets[i];
+    if (!validString(SOCKET.name) || !validString(SOCKET.itemType)) return false;
+    if (SOCKET.type >= std::size(SOCKET_TYPES)) return false;
+  }
+
+  return validateStructure();
+}
+
+bool BinaryPackage::validateStructure() const
+{
+  auto const &HEADER = *m_header;
+  constexpr uint16_t const MAX_SOCKETS{ std::numeric_limits<uint8_t>::max() };
+
+  // Every package belongs to exactly one element, package 0 to the saved package itself.
+  std::vector<uint32_t> owners(HEADER.packageCount, NONE);
+  for (uint32_t i = 0; i < HEADER.elementCount; ++i) {
+    auto const &ELEMENT = m_elements[i];
+    if (ELEMENT.inputCount > MAX_SOCKETS || ELEMENT.outputCount > MAX_SOCKETS) return false;
+    if (ELEMENT.package == NONE) continue;
+    if (owners[ELEMENT.package] != NONE) return false;
+    owners[ELEMENT.package] = i;
+  }
+  if (owners[0] != 0) return false;
+
+  // Every element other than the saved package sits in exactly one package.
+  std::vector<uint32_t> parents(HEADER.elementCount, NONE);
+  for (uint32_t i = 0; i < HEADER.packageCount; ++i) {
+    auto const &PACKAGE = m_packages[i];
+    if (owners[i] == NONE) return false;
+
+    for (uint32_t e = PACKAGE.firstElement; e < PACKAGE.firstElement + PACKAGE.elementCount; ++e) {
+      if (e == 0 || parents[e] != NONE || m_elements[e].type == NONE) return false;
+      parents[e] = i;
+    }
+  }
+
+  // Walking up from any package has to reach package 0, anything else is a package nested in itself.
+  for (uint32_t i = 1; i < HEADER.packageCount; ++i) {
+    uint32_t package{ i };
+    for (uint32_t depth = 0; package != 0; ++depth) {
+      if (depth == HEADER.packageCount) return false;
+      package = parents[owners[package]];
+      if (package == NONE || package == i) return false;
+    }
+  }
+
+  // Connections name element ids of their own package, 0 being the package itself.
+  std::unordered_map<uint64_t, uint32_t> ids{};
+  for (uint32_t i = 0; i < HEADER.packageCount; ++i) {
+    auto const &PACKAGE = m_packages[i];
+
+    ids.clear();
+    for (uint32_t e = PACKAGE.firstElement; e < PACKAGE.firstElement + PACKAGE.elementCount; ++e)
+      ids[m_elements[e].id] = e;
+
+    auto const find = [this, &ids, OWNER = owners[i]](uint64_t const a_id) -> ElementRecord const * {
+      if (a_id == 0) return &m_elements[OWNER];
+      auto const IT = ids.find(a_id);
+      return IT == ids.end() ? nullptr : &m_elements[IT->second];
+    };
+
+    for (uint32_t c = PACKAGE.firstConnection; c < PACKAGE.firstConnection + PACKAGE.connectionCount; ++c) {
+      auto const &CONNECTION = m_connections[c];
+      auto const SOURCE = find(CONNECTION.fromId);
+      auto const TARGET = find(CONNECTION.toId);
+      if (SOURCE == nullptr || TARGET == nullptr) return false;
+
+      auto const SOURCE_SOCKETS = CONNECTION.fromId == 0 ? SOURCE->inputCount : SOURCE->outputCount;
+      auto const TARGET_SOCKETS = CONNECTION.toId == 0 ? TARGET->outputCount : TARGET->inputCount;
+      if (CONNECTION.fromSocket >= SOURCE_SOCKETS || CONNECTION.toSocket >= TARGET_SOCKETS) return false;
+    }
+  }
+
+  return true;
+}
+
+std::string_view BinaryPackage::string(StringId const a_id) const
+{
+  if (a_id == NONE) return {};
+  auto const &STRING = m_strings[a_id];
+  return std::string_view{ m_data + STRING.offset, STRING.size };
+}
+
+char const *BinaryPackage::c_str(StringId const a_id) const
+{
+  return a_id == NONE ? "" : m_data + m_strings[a_id].offset;
+}
+
+BinaryPackage::Json BinaryPackage::elementToJson(uint32_t const a_element) const
+{
+  auto const &RECORD = m_elements[a_element];
+
+  auto json = Json::object();
+  if (RECORD.propertiesSize != 0) {
+    std::vector<uint8_t> const CBOR(m_data + RECORD.propertiesOffset,
+                                    m_data + RECORD.propertiesOffset + RECORD.propertiesSize);
+    json = Json::from_cbor(CBOR);
+  }
+
+  auto text = [this](StringId const a_id) { return std::string{ string(a_id) }; };
+
+  auto &element = json["element"];
+  element["id"] = RECORD.id;
+  if (RECORD.name != NONE) element["name"] = text(RECORD.name);
+  if (RECORD.description != NONE) element["description"] = text(RECORD.description);
+  if (RECORD.type != NONE) element["type"] = text(RECORD.type);
+  if (RECORD.flags & ElementRecord::eHasRotate) element["rotate"] = (RECORD.flags & ElementRecord::eRotate) != 0;
+  if (RECORD.flags & ElementRecord::eHasInvertH) element["invertH"] = (RECORD.flags & ElementRecord::eInvertH) != 0;
+  element["min_inputs"] = RECORD.minInputs;
+  element["max_inputs"] = RECORD.maxInputs;
+  element["min_outputs"] = RECORD.minOutputs;
+  element["max_outputs"] = RECORD.maxOutputs;
+  element["default_new_input_flags"] = RECORD.defaultNewInputFlags;
+  element["default_new_output_flags"] = RECORD.defaultNewOutputFlags;
+
+  auto sockets = [&](uint32_t const a_first, uint32_t const a_count) {
+    auto jsonSockets = Json::array();
+    for (uint32_t i = 0; i < a_count; ++i) {
+      auto const &SOCKET = m_sockets[a_first + i];
+      Json socket{};
+      socket["socket"] = i;
+      socket["type"] = SOCKET_TYPES[SOCKET.type];
+      if (SOCKET.itemType != NONE) socket["siType"] = text(SOCKET.itemType);
+      if (SOCKET.name != NONE) socket["name"] = text(SOCKET.name);
+      socket["flags"] = SOCKET.flags;
+      socket["inFlags"] = SOCKET.inFlags;
+      jsonSockets.push_back(socket);
+    }
+    return jsonSockets;
+  };
+  element["io"]["inputs"] = sockets(RECORD.firstSocket, RECORD.inputCount);
+  element["io"]["outputs"] = sockets(RECORD.firstSocket + RECORD.inputCount, RECORD.outputCount);
+
+  auto &node = json["node"];
+  node["position"]["x"] = RECORD.position[0];
+  node["position"]["y"] = RECORD.position[1];
+  node["iconify"] = (RECORD.flags & ElementRecord::eIconify) != 0;
+  node["iconifying_hides_central_widget"] = (RECORD.flags & ElementRecord::eIconifyingHidesCentralWidget) != 0;
+
+  if (RECORD.package == NONE) return json;
+
+  auto const &PACKAGE = m_packages[RECORD.package];
+  node["inputs_position"]["x"] = PACKAGE.inputsPosition[0];
+  node["inputs_position"]["y"] = PACKAGE.inputsPosition[1];
+  node["outputs_position"]["x"] = PACKAGE.outputsPosition[0];
+  node["outputs_position"]["y"] = PACKAGE.outputsPosition[1];
+
+  auto &package = json["package"];
+  if (PACKAGE.description != NONE) package["description"] = text(PACKAGE.description);
+  if (PACKAGE.path != NONE) package["path"] = text(PACKAGE.path);
+  if (PACKAGE.icon != NONE) package["icon"] = text(PACKAGE.icon);
+
+  if (!(PACKAGE.flags & PackageRecord::eHasContent)) return json;
+
+  auto elements = Json::array();
+  for (uint32_t i = 0; i < PACKAGE.elementCount; ++i) elements.push_back(elementToJson(PACKAGE.firstElement + i));
+  package["elements"] = elements;
+
+  auto connections = Json::array();
+  for (uint32_t i = 0; i < PACKAGE.connectionCount; ++i) {
+    auto const &CONNECTION = m_connections[PACKAGE.firstConnection + i];
+    Json jsonConnection{}, jsonConnect{}, jsonTo{};
+
+    jsonConnect["id"] = CONNECTION.fromId;
+    jsonConnect["socket"] = CONNECTION.fromSocket;
+    if (CONNECTION.flags & ConnectionRecord::eHasFromFlags) jsonConnect["flags"] = CONNECTION.fromFlags;
+    jsonTo["id"] = CONNECTION.toId;
+    jsonTo["socket"] = CONNECTION.toSocket;
+    if (CONNECTION.flags & ConnectionRecord::eHasToFlags) jsonTo["flags"] = CONNECTION.toFlags;
+
+    jsonConnection["connect"] = jsonConnect;
+    jsonConnection["to"] = jsonTo;
+    connections.push_back(jsonConnection);
+  }
+  package["connections"] = connections;
+
+  return json;
+}
+
+} // namespace spaghetti
@@ -0,0 +1,80 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "edit_queue.h"
+
+namespace spaghetti {
+
+EditQueue::EditQueue()
+  : m_head{ &m_stub }
+  , m_tail{ &m_stub }
+{
+}
+
+EditQueue::~EditQueue()
+{
+  Edit edit{};
+  while (pop(edit)) continue;
+}
+
+void EditQueue::push(Edit a_edit)
+{
+  auto const node = new Node;
+  node->edit = std::move(a_edit);
+  push(node);
+}
+
+void EditQueue::push(Node *const a_node)
+{
+  a_node->next.store(nullptr, std::memory_order_relaxed);
+  auto const previous = m_head.exchange(a_node, std::memory_order_acq_rel);
+  previous->next.store(a_node, std::memory_order_release);
+}
+
+bool EditQueue::pop(Edit &a_edit)
+{
+  auto tail = m_tail;
+  auto next = tail->next.load(std::memory_order_acquire);
+
+  if (tail == &m_stub) {
+    if (!next) return false;
+    m_tail = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (!next) {
+    // Either the queue holds a single edit or a producer is between its exchange and its link; in the latter
+    // case the edit is picked up on the next drain. Otherwise re-insert the stub so the last node can be taken.
+    if (tail != m_head.load(std::memory_order_acquire)) return false;
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (!next) return false;
+  }
+
+  m_tail = next;
+  a_edit = std::move(tail->edit);
+  delete tail;
+  return true;
+}
+
+} // namespace spaghetti
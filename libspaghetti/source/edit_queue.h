@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_EDIT_QUEUE_H
+#define SPAGHETTI_EDIT_QUEUE_H
+
+#include <atomic>
+#include <functional>
+
+namespace spaghetti {
+
+// Intrusive multi-producer/single-consumer queue (Vyukov). push() is a single atomic exchange and never
+// waits, so any thread can hand graph edits to the thread driving the ticks, which drains them with pop().
+class EditQueue final {
+ public:
+  using Edit = std::function<void()>;
+
+  EditQueue();
+  ~EditQueue();
+
+  EditQueue(EditQueue const &) = delete;
+  EditQueue &operator=(EditQueue const &) = delete;
+
+  void push(Edit a_edit);
+  bool pop(Edit &a_edit);
+
+ private:
+  struct Node {
+    std::atomic<Node *> next{};
+    Edit edit{};
+  };
+
+  void push(Node *const a_node);
+
+ private:
+  alignas(64) std::atomic<Node *> m_head{};
+  alignas(64) Node *m_tail{};
+  Node m_stub{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_EDIT_QUEUE_H
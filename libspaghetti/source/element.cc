@@ -29,11 +29,63 @@
 #include <string>
 #include <stdexcept>
 
+#include "spaghetti/binary_package.h"
 #include "spaghetti/package.h"
 #include "spaghetti/logger.h"
 
 namespace spaghetti {
 
+namespace {
+
+thread_local SignalStore *t_scopeSignals{};
+
+Package *dispatcherOf(Element *const a_element)
+{
+  if (a_element->package()) return a_element->package();
+  return a_element->hash() == Package::HASH ? static_cast<Package *>(a_element) : nullptr;
+}
+
+} // namespace
+
+Element::Value Element::IOSocket::value() const
+{
+  switch (handle.type) {
+    case ValueType::eBool: return get<bool>();
+    case ValueType::eInt: return get<int32_t>();
+    case ValueType::eFloat: return get<float>();
+    case ValueType::eByte: return get<uint8_t>();
+    case ValueType::eWord64: return get<uint64_t>();
+  }
+  return Value{};
+}
+
+void Element::IOSocket::setValue(Value const &a_value)
+{
+  std::visit([this](auto const a_held) { set(a_held); }, a_value);
+}
+
+Element::SignalScope::SignalScope(SignalStore &a_store)
+  : m_previous{ t_scopeSignals }
+{
+  t_scopeSignals = &a_store;
+}
+
+Element::SignalScope::~SignalScope()
+{
+  t_scopeSignals = m_previous;
+}
+
+Element::Element()
+  : m_scopeSignals{ t_scopeSignals }
+{
+}
+
+Element::~Element()
+{
+  clearInputs();
+  clearOutputs();
+}
+
 void Element::serialize(Element::Json &a_json)
 {
   auto &jsonElement = a_json["element"];
@@ -244,6 +296,49 @@ void Element::deserialize(Json const &a_json, const bool isRootPackage)
   for (auto &&socket : OUTPUTS) add_socket(socket, false, outputsCount, isRootPackage);
 }
 
+void Element::restore(BinaryPackage const &a_file, uint32_t const a_element)
+{
+  using Flags = BinaryPackage::ElementRecord::Flags;
+
+  auto const &RECORD = a_file.element(a_element);
+  bool const IS_ROOT_PACKAGE{ m_package == nullptr };
+
+  setName(std::string{ a_file.string(RECORD.name) });
+  setDesc(std::string{ a_file.string(RECORD.description) });
+  setRotate((RECORD.flags & Flags::eRotate) != 0);
+  setInvertH((RECORD.flags & Flags::eInvertH) != 0);
+  setPosition(RECORD.position[0], RECORD.position[1]);
+  clearInputs();
+  clearOutputs();
+  setMinInputs(RECORD.minInputs);
+  setMaxInputs(RECORD.maxInputs);
+  setMinOutputs(RECORD.minOutputs);
+  setMaxOutputs(RECORD.maxOutputs);
+  setDefaultNewInputFlags(RECORD.defaultNewInputFlags);
+  setDefaultNewOutputFlags(RECORD.defaultNewOutputFlags);
+  iconify((RECORD.flags & Flags::eIconify) != 0);
+  setIconifyingHidesCentralWidget((RECORD.flags & Flags::eIconifyingHidesCentralWidget) != 0);
+
+  // Socket item types resolve the same way deserialize() does it.
+  auto itemType = [IS_ROOT_PACKAGE](std::string_view const a_type, bool const a_input) {
+    if (IS_ROOT_PACKAGE) return a_input ? SocketItemType::eOutput : SocketItemType::eInput;
+    if (a_type == "i") return SocketItemType::eInput;
+    if (a_type == "o") return SocketItemType::eOutput;
+    if (a_type == "d") return SocketItemType::eDynamic;
+    return a_input ? SocketItemType::eInput : SocketItemType::eOutput;
+  };
+
+  uint32_t const SOCKETS_COUNT{ uint32_t{ RECORD.inputCount } + RECORD.outputCount };
+  for (uint32_t i = 0; i < SOCKETS_COUNT; ++i) {
+    auto const &SOCKET = a_file.socket(RECORD.firstSocket + i);
+    bool const IS_INPUT{ i < RECORD.inputCount };
+    auto const TYPE = static_cast<ValueType>(SOCKET.type);
+    std::string const NAME{ a_file.string(SOCKET.name) };
+    auto const ITEM_TYPE = itemType(a_file.string(SOCKET.itemType), IS_INPUT);
+    IS_INPUT ? addInput(TYPE, NAME, SOCKET.flags, ITEM_TYPE) : addOutput(TYPE, NAME, SOCKET.flags, ITEM_TYPE);
+  }
+}
+
 void Element::setName(std::string const &a_name)
 {
   auto const OLD_NAME = m_name;
@@ -305,13 +400,21 @@ void Element::setInputName(uint8_t const a_input, std::string const &a_name)
 
 void Element::removeInput()
 {
+  // Connections name sockets by index, left behind they would feed whatever input gets added there next.
+  uint8_t const INDEX{ static_cast<uint8_t>(m_inputs.size() - 1) };
+  if (m_package) m_package->unlinkSocket(m_id, INDEX, true);
+  if (hash() == Package::HASH) static_cast<Package *>(this)->unlinkSocket(0, INDEX, true);
+
+  m_inputs.back().store->release(m_inputs.back().storage);
   m_inputs.pop_back();
+  if (m_package) m_package->invalidateSchedule();
 
   handleEvent(Event{ EventType::eInputRemoved, EventEmpty{} });
 }
 
 void Element::clearInputs()
 {
+  for (auto &input : m_inputs) input.store->release(input.storage);
   m_inputs.clear();
 }
 
@@ -356,13 +459,20 @@ void Element::setOutputName(uint8_t const a_output, std::string const &a_name)
 
 void Element::removeOutput()
 {
+  uint8_t const INDEX{ static_cast<uint8_t>(m_outputs.size() - 1) };
+  if (m_package) m_package->unlinkSocket(m_id, INDEX, false);
+  if (hash() == Package::HASH) static_cast<Package *>(this)->unlinkSocket(0, INDEX, false);
+
+  m_outputs.back().store->release(m_outputs.back().storage);
   m_outputs.pop_back();
+  if (m_package) m_package->invalidateSchedule();
 
   handleEvent(Event{ EventType::eOutputRemoved, EventEmpty{} });
 }
 
 void Element::clearOutputs()
 {
+  for (auto &output : m_outputs) output.store->release(output.storage);
   m_outputs.clear();
 }
 
@@ -383,6 +493,7 @@ void Element::setIOValueType(bool const a_input, uint8_t const a_id, ValueType c
 
   io.type = a_type;
   resetIOSocketValue(io);
+  if (m_package) m_package->invalidateSchedule();
 
   handleEvent(Event{ EventType::eIOTypeChanged, EventIOTypeChanged{ a_input, a_id, OLD_TYPE, a_type } });
 }
@@ -394,17 +505,59 @@ bool Element::connect(size_t const a_sourceId, uint8_t const a_outputId, uint8_t
 
 void Element::resetIOSocketValue(IOSocket &a_io)
 {
-  switch (a_io.type) {
-    case ValueType::eBool: a_io.value = false; break;
-    case ValueType::eInt: a_io.value = 0; break;
-    case ValueType::eFloat: a_io.value = 0.0f; break;
-    case ValueType::eByte: a_io.value = (uint8_t)0; break;
-    case ValueType::eWord64: a_io.value = (uint64_t)0; break;
+  a_io.handle = a_io.storage;
+
+  if (a_io.store && a_io.storage.isValid() && a_io.storage.type == a_io.type) {
+    a_io.store->reset(a_io.storage);
+    return;
   }
+
+  // Growing a shared store may move its columns, so the dispatch thread must not be reading them.
+  auto const dispatcher = dispatcherOf(this);
+  if (dispatcher) dispatcher->pauseDispatchThread();
+
+  if (a_io.store) a_io.store->release(a_io.storage);
+  a_io.store = &signals();
+  a_io.storage = a_io.store->allocate(a_io.type);
+  a_io.handle = a_io.storage;
+
+  if (dispatcher) dispatcher->resumeDispatchThread();
+}
+
+SignalStore &Element::signals()
+{
+  if (m_package) return m_package->signals();
+  if (m_scopeSignals) return *m_scopeSignals;
+  if (!m_signals) m_signals = std::make_unique<SignalStore>();
+  return *m_signals;
+}
+
+void Element::bindSignals(SignalStore &a_store)
+{
+  auto const rebind = [&a_store](IOSocket &a_io) {
+    if (a_io.store == &a_store) {
+      a_io.handle = a_io.storage;
+      return;
+    }
+
+    auto const VALUE = a_io.value();
+    a_io.store->release(a_io.storage);
+    a_io.store = &a_store;
+    a_io.storage = a_store.allocate(a_io.type);
+    a_io.handle = a_io.storage;
+    a_io.setValue(VALUE);
+  };
+
+  for (auto &input : m_inputs) rebind(input);
+  for (auto &output : m_outputs) rebind(output);
+
+  m_scopeSignals = nullptr;
+  m_signals.reset();
 }
 
 void Element::handleEvent(Event const &a_event)
 {
+  markDirty();
   onEvent(a_event);
   if (m_handler) m_handler(a_event);
 }
@@ -43,14 +43,14 @@ void Nand::calculate()
 {
   bool allSets{ true };
   for (auto &input : m_inputs) {
-    bool const VALUE{ std::get<bool>(input.value) };
+    bool const VALUE{ input.get<bool>() };
     if (!VALUE) {
       allSets = false;
       break;
     }
   }
 
-  m_outputs[0].value = !allSets;
+  m_outputs[0].set(!allSets);
 }
 
 } // namespace spaghetti::elements::gates
@@ -43,12 +43,12 @@ void Or::calculate()
 {
   bool somethingSet{ false };
   for (auto &input : m_inputs) {
-    bool const VALUE{ std::get<bool>(input.value) };
+    bool const VALUE{ input.get<bool>() };
     somethingSet |= VALUE;
     if (VALUE) break;
   }
 
-  m_outputs[0].value = somethingSet;
+  m_outputs[0].set(somethingSet);
 }
 
 } // namespace spaghetti::elements::gates
@@ -41,11 +41,11 @@ AssignFloat::AssignFloat()
 
 void AssignFloat::calculate()
 {
-  bool const IF{ std::get<bool>(m_inputs[0].value) };
-  float const A{ std::get<float>(m_inputs[1].value) };
-  float const B{ std::get<float>(m_inputs[2].value) };
+  bool const IF{ m_inputs[0].get<bool>() };
+  float const A{ m_inputs[1].get<float>() };
+  float const B{ m_inputs[2].get<float>() };
 
-  m_outputs[0].value = IF ? B : A;
+  m_outputs[0].set(IF ? B : A);
 }
 
 } // namespace spaghetti::elements::logic
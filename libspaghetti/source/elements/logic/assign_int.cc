@@ -41,11 +41,11 @@ AssignInt::AssignInt()
 
 void AssignInt::calculate()
 {
-  bool const IF{ std::get<bool>(m_inputs[0].value) };
-  int32_t const A{ std::get<int32_t>(m_inputs[1].value) };
-  int32_t const B{ std::get<int32_t>(m_inputs[2].value) };
+  bool const IF{ m_inputs[0].get<bool>() };
+  int32_t const A{ m_inputs[1].get<int32_t>() };
+  int32_t const B{ m_inputs[2].get<int32_t>() };
 
-  m_outputs[0].value = IF ? B : A;
+  m_outputs[0].set(IF ? B : A);
 }
 
 } // namespace spaghetti::elements::logic
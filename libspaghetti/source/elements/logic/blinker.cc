@@ -26,6 +26,8 @@ namespace spaghetti::elements::logic {
 
 Blinker::Blinker()
 {
+  setTimeDriven(true);
+
   setMinInputs(3);
   setMaxInputs(3);
   setMinOutputs(1);
@@ -47,16 +49,16 @@ void Blinker::update(duration_t const &a_delta)
     if (m_time >= RATE) {
       m_time = duration_t{};
       m_state = !m_state;
-      m_outputs[0].value = m_state;
+      m_outputs[0].set(m_state);
     }
   }
 }
 
 void Blinker::calculate()
 {
-  bool const ENABLED = std::get<bool>(m_inputs[0].value);
-  duration_t const HIGH_RATE = duration_t{ std::get<int>(m_inputs[1].value) };
-  duration_t const LOW_RATE = duration_t{ std::get<int>(m_inputs[2].value) };
+  bool const ENABLED = m_inputs[0].get<bool>();
+  duration_t const HIGH_RATE = duration_t{ m_inputs[1].get<int32_t>() };
+  duration_t const LOW_RATE = duration_t{ m_inputs[2].get<int32_t>() };
 
   bool changed{};
   changed |= ENABLED != m_enabled;
@@ -70,7 +72,7 @@ void Blinker::calculate()
   if (changed) {
     m_time = duration_t{};
     m_state = false;
-    m_outputs[0].value = m_state;
+    m_outputs[0].set(m_state);
   }
 }
 
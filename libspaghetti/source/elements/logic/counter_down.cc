@@ -42,9 +42,9 @@ CounterDown::CounterDown()
 
 void CounterDown::calculate()
 {
-  bool const CD{ std::get<bool>(m_inputs[0].value) };
-  bool const LOAD{ std::get<bool>(m_inputs[1].value) };
-  int32_t const PRESET_VALUE{ std::get<int32_t>(m_inputs[2].value) };
+  bool const CD{ m_inputs[0].get<bool>() };
+  bool const LOAD{ m_inputs[1].get<bool>() };
+  int32_t const PRESET_VALUE{ m_inputs[2].get<int32_t>() };
 
   if (LOAD != m_lastLoad && LOAD) {
     m_preset = PRESET_VALUE;
@@ -54,8 +54,8 @@ void CounterDown::calculate()
 
   if (CD != m_lastCD && CD && m_current > 0) m_state = --m_current == 0;
 
-  m_outputs[0].value = m_state;
-  m_outputs[1].value = m_current;
+  m_outputs[0].set(m_state);
+  m_outputs[1].set(m_current);
 
   m_lastCD = CD;
   m_lastLoad = LOAD;
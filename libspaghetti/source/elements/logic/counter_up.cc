@@ -42,9 +42,9 @@ CounterUp::CounterUp()
 
 void CounterUp::calculate()
 {
-  bool const CU{ std::get<bool>(m_inputs[0].value) };
-  bool const RESET{ std::get<bool>(m_inputs[1].value) };
-  int32_t const PRESET_VALUE{ std::get<int32_t>(m_inputs[2].value) };
+  bool const CU{ m_inputs[0].get<bool>() };
+  bool const RESET{ m_inputs[1].get<bool>() };
+  int32_t const PRESET_VALUE{ m_inputs[2].get<int32_t>() };
 
   if (RESET != m_lastReset && RESET) {
     m_preset = PRESET_VALUE;
@@ -54,8 +54,8 @@ void CounterUp::calculate()
 
   if (CU != m_lastCU && CU && m_current < m_preset) m_state = ++m_current == m_preset;
 
-  m_outputs[0].value = m_state;
-  m_outputs[1].value = m_current;
+  m_outputs[0].set(m_state);
+  m_outputs[1].set(m_current);
 
   m_lastCU = CU;
   m_lastReset = RESET;
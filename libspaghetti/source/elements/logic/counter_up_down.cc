@@ -45,11 +45,11 @@ CounterUpDown::CounterUpDown()
 
 void CounterUpDown::calculate()
 {
-  bool const CU{ std::get<bool>(m_inputs[0].value) };
-  bool const CD{ std::get<bool>(m_inputs[1].value) };
-  bool const RESET{ std::get<bool>(m_inputs[2].value) };
-  bool const LOAD{ std::get<bool>(m_inputs[3].value) };
-  int32_t const PRESET_VALUE{ std::get<int32_t>(m_inputs[4].value) };
+  bool const CU{ m_inputs[0].get<bool>() };
+  bool const CD{ m_inputs[1].get<bool>() };
+  bool const RESET{ m_inputs[2].get<bool>() };
+  bool const LOAD{ m_inputs[3].get<bool>() };
+  int32_t const PRESET_VALUE{ m_inputs[4].get<int32_t>() };
 
   if (RESET != m_lastReset && RESET) {
     m_preset = PRESET_VALUE;
@@ -69,9 +69,9 @@ void CounterUpDown::calculate()
   m_stateCD = m_current == 0;
   m_stateCU = m_current == m_preset;
 
-  m_outputs[0].value = m_stateCU;
-  m_outputs[1].value = m_stateCD;
-  m_outputs[2].value = m_current;
+  m_outputs[0].set(m_stateCU);
+  m_outputs[1].set(m_stateCD);
+  m_outputs[2].set(m_current);
 
   m_lastCU = CU;
   m_lastCD = CD;
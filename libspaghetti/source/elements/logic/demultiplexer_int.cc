@@ -43,14 +43,14 @@ DemultiplexerInt::DemultiplexerInt()
 
 void DemultiplexerInt::calculate()
 {
-  int32_t const SELECT{ std::get<int32_t>(m_inputs[0].value) };
-  int32_t const VALUE{ std::get<int32_t>(m_inputs[1].value) };
+  int32_t const SELECT{ m_inputs[0].get<int32_t>() };
+  int32_t const VALUE{ m_inputs[1].get<int32_t>() };
   int32_t const SIZE{ static_cast<int32_t>(m_outputs.size()) - 1 };
   int32_t const INDEX{ std::clamp<int32_t>(SELECT, 0, SIZE) };
 
-  for (auto &&output : m_outputs) output.value = 0;
+  for (auto &&output : m_outputs) output.set(0);
 
-  m_outputs[static_cast<size_t>(INDEX)].value = VALUE;
+  m_outputs[static_cast<size_t>(INDEX)].set(VALUE);
 }
 
 } // namespace spaghetti::elements::logic
@@ -41,10 +41,10 @@ IfEqual::IfEqual()
 
 void IfEqual::calculate()
 {
-  float const A{ std::get<float>(m_inputs[0].value) };
-  float const B{ std::get<float>(m_inputs[1].value) };
+  float const A{ m_inputs[0].get<float>() };
+  float const B{ m_inputs[1].get<float>() };
 
-  m_outputs[0].value = spaghetti::nearly_equal(A, B);
+  m_outputs[0].set(spaghetti::nearly_equal(A, B));
 }
 
 } // namespace spaghetti::elements::logic
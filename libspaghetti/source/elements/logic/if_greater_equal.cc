@@ -40,10 +40,10 @@ IfGreaterEqual::IfGreaterEqual()
 
 void IfGreaterEqual::calculate()
 {
-  float const A{ std::get<float>(m_inputs[0].value) };
-  float const B{ std::get<float>(m_inputs[1].value) };
+  float const A{ m_inputs[0].get<float>() };
+  float const B{ m_inputs[1].get<float>() };
 
-  m_outputs[0].value = A >= B;
+  m_outputs[0].set(A >= B);
 }
 
 } // namespace spaghetti::elements::logic
@@ -39,11 +39,11 @@ Latch ::Latch()
 
 void Latch ::calculate()
 {
-  bool const INPUT{ std::get<bool>(m_inputs[0].value) };
+  bool const INPUT{ m_inputs[0].get<bool>() };
 
   if (INPUT != m_lastValue && INPUT) m_state = !m_state;
 
-  m_outputs[0].value = m_state;
+  m_outputs[0].set(m_state);
 
   m_lastValue = INPUT;
 }
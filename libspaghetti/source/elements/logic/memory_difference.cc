@@ -40,15 +40,15 @@ MemoryDifference ::MemoryDifference()
 
 void MemoryDifference ::calculate()
 {
-  int32_t const INPUT{ std::get<int32_t>(m_inputs[0].value) };
+  int32_t const INPUT{ m_inputs[0].get<int32_t>() };
 
   if (INPUT != m_currentValue) {
     m_lastValue = m_currentValue;
     m_currentValue = INPUT;
   }
 
-  m_outputs[0].value = m_currentValue;
-  m_outputs[1].value = m_lastValue;
+  m_outputs[0].set(m_currentValue);
+  m_outputs[1].set(m_lastValue);
 }
 
 } // namespace spaghetti::elements::logic
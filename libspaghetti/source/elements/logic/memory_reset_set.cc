@@ -40,13 +40,13 @@ MemoryResetSet::MemoryResetSet()
 
 void MemoryResetSet::calculate()
 {
-  bool const SET{ std::get<bool>(m_inputs[0].value) };
-  bool const RESET{ std::get<bool>(m_inputs[1].value) };
+  bool const SET{ m_inputs[0].get<bool>() };
+  bool const RESET{ m_inputs[1].get<bool>() };
 
   if (RESET)
-    m_outputs[0].value = false;
+    m_outputs[0].set(false);
   else if (SET)
-    m_outputs[0].value = true;
+    m_outputs[0].set(true);
 }
 
 } // namespace spaghetti::elements::logic
@@ -40,13 +40,13 @@ MemorySetReset::MemorySetReset()
 
 void MemorySetReset::calculate()
 {
-  bool const SET{ std::get<bool>(m_inputs[0].value) };
-  bool const RESET{ std::get<bool>(m_inputs[1].value) };
+  bool const SET{ m_inputs[0].get<bool>() };
+  bool const RESET{ m_inputs[1].get<bool>() };
 
   if (SET)
-    m_outputs[0].value = true;
+    m_outputs[0].set(true);
   else if (RESET)
-    m_outputs[0].value = false;
+    m_outputs[0].set(false);
 }
 
 } // namespace spaghetti::elements::logic
@@ -28,6 +28,8 @@ namespace spaghetti::elements::logic {
 PID::PID()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(7);
   setMaxInputs(7);
   setMinOutputs(1);
@@ -51,13 +53,13 @@ void PID::update(duration_t const &a_delta)
 
 void PID::calculate()
 {
-  float const PV{ std::get<float>(m_inputs[0].value) };
-  float const SP{ std::get<float>(m_inputs[1].value) };
-  float const KP{ std::get<float>(m_inputs[2].value) };
-  float const KI{ std::get<float>(m_inputs[3].value) };
-  float const KD{ std::get<float>(m_inputs[4].value) };
-  float const CV_HIGH{ std::get<float>(m_inputs[5].value) };
-  float const CV_LOW{ std::get<float>(m_inputs[6].value) };
+  float const PV{ m_inputs[0].get<float>() };
+  float const SP{ m_inputs[1].get<float>() };
+  float const KP{ m_inputs[2].get<float>() };
+  float const KI{ m_inputs[3].get<float>() };
+  float const KD{ m_inputs[4].get<float>() };
+  float const CV_HIGH{ m_inputs[5].get<float>() };
+  float const CV_LOW{ m_inputs[6].get<float>() };
 
   float const ERROR{ SP - PV };
 
@@ -72,7 +74,7 @@ void PID::calculate()
 
   m_lastError = ERROR;
 
-  m_outputs[0].value = CV;
+  m_outputs[0].set(CV);
 }
 
 } // namespace spaghetti::elements::logic
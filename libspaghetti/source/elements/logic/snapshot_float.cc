@@ -40,12 +40,12 @@ SnapshotFloat::SnapshotFloat()
 
 void SnapshotFloat::calculate()
 {
-  bool const INPUT{ std::get<bool>(m_inputs[0].value) };
-  float const VALUE{ std::get<float>(m_inputs[1].value) };
+  bool const INPUT{ m_inputs[0].get<bool>() };
+  float const VALUE{ m_inputs[1].get<float>() };
 
   if (INPUT) m_value = VALUE;
 
-  m_outputs[0].value = m_value;
+  m_outputs[0].set(m_value);
 }
 
 } // namespace spaghetti::elements::logic
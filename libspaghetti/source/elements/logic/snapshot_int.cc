@@ -40,12 +40,12 @@ SnapshotInt::SnapshotInt()
 
 void SnapshotInt::calculate()
 {
-  bool const INPUT{ std::get<bool>(m_inputs[0].value) };
-  int32_t const VALUE{ std::get<int32_t>(m_inputs[1].value) };
+  bool const INPUT{ m_inputs[0].get<bool>() };
+  int32_t const VALUE{ m_inputs[1].get<int32_t>() };
 
   if (INPUT) m_value = VALUE;
 
-  m_outputs[0].value = m_value;
+  m_outputs[0].set(m_value);
 }
 
 } // namespace spaghetti::elements::logic
@@ -38,12 +38,14 @@ Switch::Switch()
 
 void Switch::toggle()
 {
-  m_outputs[0].value = !std::get<bool>(m_outputs[0].value);
+  m_outputs[0].set(!m_outputs[0].get<bool>());
+  markDirty();
 }
 
 void Switch::set(bool a_state)
 {
-  m_outputs[0].value = a_state;
+  m_outputs[0].set(a_state);
+  markDirty();
 }
 
 } // namespace spaghetti::elements::logic
@@ -39,18 +39,18 @@ TriggerFalling::TriggerFalling()
 
 void TriggerFalling::calculate()
 {
-  bool const INPUT{ std::get<bool>(m_inputs[0].value) };
+  bool const INPUT{ m_inputs[0].get<bool>() };
 
   switch (m_state) {
     case State::eWait:
       if (INPUT != m_lastValue && !INPUT) m_state = State::eSet;
       break;
     case State::eSet:
-      m_outputs[0].value = true;
+      m_outputs[0].set(true);
       m_state = State::eReset;
       break;
     case State::eReset:
-      m_outputs[0].value = false;
+      m_outputs[0].set(false);
       m_state = State::eWait;
       break;
   }
@@ -39,10 +39,10 @@ Abs::Abs()
 
 void Abs::calculate()
 {
-  float const VALUE{ std::get<float>(m_inputs[0].value) };
+  float const VALUE{ m_inputs[0].get<float>() };
   float const ABS{ std::abs(VALUE) };
 
-  m_outputs[0].value = ABS;
+  m_outputs[0].set(ABS);
 }
 
 } // namespace spaghetti::elements::math
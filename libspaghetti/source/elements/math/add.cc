@@ -42,9 +42,9 @@ Add::Add()
 void Add::calculate()
 {
   float sum{};
-  for (auto &&input : m_inputs) sum += std::get<float>(input.value);
+  for (auto &&input : m_inputs) sum += input.get<float>();
 
-  m_outputs[0].value = sum;
+  m_outputs[0].set(sum);
 }
 
 } // namespace spaghetti::elements::math
@@ -42,10 +42,10 @@ AddIf::AddIf()
 
 void AddIf::calculate()
 {
-  bool const ENABLED{ std::get<bool>(m_inputs[0].value) };
+  bool const ENABLED{ m_inputs[0].get<bool>() };
 
   if (ENABLED != m_enabled && !ENABLED) {
-    m_outputs[0].value = 0.0f;
+    m_outputs[0].set(0.0f);
     return;
   }
 
@@ -56,9 +56,9 @@ void AddIf::calculate()
   float sum{};
 
   size_t const SIZE{ m_inputs.size() };
-  for (size_t i = 1; i < SIZE; ++i) sum += std::get<float>(m_inputs[i].value);
+  for (size_t i = 1; i < SIZE; ++i) sum += m_inputs[i].get<float>();
 
-  m_outputs[0].value = sum;
+  m_outputs[0].set(sum);
 }
 
 } // namespace spaghetti::elements::math
@@ -39,10 +39,10 @@ Cos::Cos()
 
 void Cos::calculate()
 {
-  float const ANGLE{ std::get<float>(m_inputs[0].value) };
+  float const ANGLE{ m_inputs[0].get<float>() };
   float const COS{ std::cos(ANGLE) };
 
-  m_outputs[0].value = COS;
+  m_outputs[0].set(COS);
 }
 
 } // namespace spaghetti::elements::math
@@ -42,10 +42,10 @@ DivideIf::DivideIf()
 
 void DivideIf::calculate()
 {
-  bool const ENABLED{ std::get<bool>(m_inputs[0].value) };
+  bool const ENABLED{ m_inputs[0].get<bool>() };
 
   if (ENABLED != m_enabled && !ENABLED) {
-    m_outputs[0].value = 0.0f;
+    m_outputs[0].set(0.0f);
     return;
   }
 
@@ -53,15 +53,15 @@ void DivideIf::calculate()
 
   if (!m_enabled) return;
 
-  float output{ std::get<float>(m_inputs[1].value) };
+  float output{ m_inputs[1].get<float>() };
   if (output == 0.0f) {
-    m_outputs[0].value = 0.0f;
+    m_outputs[0].set(0.0f);
     return;
   }
 
   size_t const SIZE{ m_inputs.size() };
   for (size_t i = 2; i < SIZE; ++i) {
-    float const VALUE{ std::get<float>(m_inputs[i].value) };
+    float const VALUE{ m_inputs[i].get<float>() };
     if (VALUE == 0.0f) {
       output = 0.0f;
       break;
@@ -69,7 +69,7 @@ void DivideIf::calculate()
     output /= VALUE;
   }
 
-  m_outputs[0].value = output;
+  m_outputs[0].set(output);
 }
 
 } // namespace spaghetti::elements::math
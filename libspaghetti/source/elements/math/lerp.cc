@@ -42,11 +42,11 @@ Lerp::Lerp()
 
 void Lerp::calculate()
 {
-  float const MIN = std::get<float>(m_inputs[0].value);
-  float const MAX = std::get<float>(m_inputs[1].value);
-  float const T = std::get<float>(m_inputs[2].value);
+  float const MIN = m_inputs[0].get<float>();
+  float const MAX = m_inputs[1].get<float>();
+  float const T = m_inputs[2].get<float>();
 
-  m_outputs[0].value = lerp(MIN, MAX, T);
+  m_outputs[0].set(lerp(MIN, MAX, T));
 }
 
 } // namespace spaghetti::elements::math
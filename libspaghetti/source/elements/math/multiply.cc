@@ -41,15 +41,15 @@ Multiply::Multiply()
 
 void Multiply::calculate()
 {
-  float output{ std::get<float>(m_inputs[0].value) };
+  float output{ m_inputs[0].get<float>() };
 
   size_t const SIZE{ m_inputs.size() };
   for (size_t i = 1; i < SIZE; ++i) {
-    float const VALUE{ std::get<float>(m_inputs[i].value) };
+    float const VALUE{ m_inputs[i].get<float>() };
     output *= VALUE;
   }
 
-  m_outputs[0].value = output;
+  m_outputs[0].set(output);
 }
 
 } // namespace spaghetti::elements::math
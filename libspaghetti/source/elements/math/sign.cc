@@ -39,9 +39,9 @@ Sign::Sign()
 
 void Sign::calculate()
 {
-  float const VALUE{ std::get<float>(m_inputs[0].value) };
+  float const VALUE{ m_inputs[0].get<float>() };
 
-  m_outputs[0].value = VALUE > 0.f ? 1.f : VALUE < 0.f ? -1.f : 0.f;
+  m_outputs[0].set(VALUE > 0.f ? 1.f : VALUE < 0.f ? -1.f : 0.f);
 }
 
 } // namespace spaghetti::elements::math
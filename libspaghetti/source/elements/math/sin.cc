@@ -39,10 +39,10 @@ Sin::Sin()
 
 void Sin::calculate()
 {
-  float const ANGLE{ std::get<float>(m_inputs[0].value) };
+  float const ANGLE{ m_inputs[0].get<float>() };
   float const SIN{ std::sin(ANGLE) };
 
-  m_outputs[0].value = SIN;
+  m_outputs[0].set(SIN);
 }
 
 } // namespace spaghetti::elements::math
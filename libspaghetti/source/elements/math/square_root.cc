@@ -39,9 +39,9 @@ SQRT::SQRT()
 
 void SQRT::calculate()
 {
-  float const VALUE{ std::get<float>(m_inputs[0].value) };
+  float const VALUE{ m_inputs[0].get<float>() };
 
-  m_outputs[0].value = std::sqrt(VALUE < 0.f ? 0.f : VALUE);
+  m_outputs[0].set(std::sqrt(VALUE < 0.f ? 0.f : VALUE));
 }
 
 } // namespace spaghetti::elements::math
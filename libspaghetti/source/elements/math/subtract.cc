@@ -41,11 +41,11 @@ Subtract::Subtract()
 
 void Subtract::calculate()
 {
-  float ret{ std::get<float>(m_inputs[0].value) };
+  float ret{ m_inputs[0].get<float>() };
   size_t const SIZE{ m_inputs.size() };
-  for (size_t i = 1; i < SIZE; ++i) ret -= std::get<float>(m_inputs[i].value);
+  for (size_t i = 1; i < SIZE; ++i) ret -= m_inputs[i].get<float>();
 
-  m_outputs[0].value = ret;
+  m_outputs[0].set(ret);
 }
 
 } // namespace spaghetti::elements::math
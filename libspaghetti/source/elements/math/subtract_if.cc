@@ -42,10 +42,10 @@ SubtractIf::SubtractIf()
 
 void SubtractIf::calculate()
 {
-  bool const ENABLED{ std::get<bool>(m_inputs[0].value) };
+  bool const ENABLED{ m_inputs[0].get<bool>() };
 
   if (ENABLED != m_enabled && !ENABLED) {
-    m_outputs[0].value = 0.0f;
+    m_outputs[0].set(0.0f);
     return;
   }
 
@@ -53,11 +53,11 @@ void SubtractIf::calculate()
 
   if (!m_enabled) return;
 
-  float ret{ std::get<float>(m_inputs[1].value) };
+  float ret{ m_inputs[1].get<float>() };
   size_t const SIZE{ m_inputs.size() };
-  for (size_t i = 2; i < SIZE; ++i) ret -= std::get<float>(m_inputs[i].value);
+  for (size_t i = 2; i < SIZE; ++i) ret -= m_inputs[i].get<float>();
 
-  m_outputs[0].value = ret;
+  m_outputs[0].set(ret);
 }
 
 } // namespace spaghetti::elements::math
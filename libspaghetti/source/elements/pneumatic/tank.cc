@@ -33,6 +33,8 @@ Tank::Tank()
   , m_pressure{ INITIAL_PRESSURE }
   , m_volume{ INITIAL_VOLUME }
 {
+  setTimeDriven(true);
+
   setMinInputs(1);
   setMinOutputs(2);
   setMaxOutputs(2);
@@ -67,10 +69,10 @@ void Tank::deserialize(Json const &a_json)
 void Tank::calculate()
 {
   float deltaP{};
-  for (auto const &input : m_inputs) deltaP += std::get<float>(input.value);
+  for (auto const &input : m_inputs) deltaP += input.get<float>();
   m_pressure += deltaP;
-  m_outputs[0].value = m_pressure;
-  m_outputs[1].value = m_volume;
+  m_outputs[0].set(m_pressure);
+  m_outputs[1].set(m_volume);
 }
 
 void Tank::setInitialPressure(float const a_pressure)
@@ -33,6 +33,8 @@ constexpr float const MAX_V = 9999999.0f;
 Valve::Valve()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(5);
   setMaxInputs(5);
   setMinOutputs(2);
@@ -55,22 +57,22 @@ void Valve::update(duration_t const &a_delta)
 
 void Valve::calculate()
 {
-  float const VALVE{ std::get<float>(m_inputs[0].value) };
-  float const P1{ std::get<float>(m_inputs[1].value) };
-  float const V1{ std::clamp(std::get<float>(m_inputs[2].value), MIN_V, MAX_V) };
-  float const P2{ std::get<float>(m_inputs[3].value) };
-  float const V2{ std::clamp(std::get<float>(m_inputs[4].value), MIN_V, MAX_V) };
+  float const VALVE{ m_inputs[0].get<float>() };
+  float const P1{ m_inputs[1].get<float>() };
+  float const V1{ std::clamp(m_inputs[2].get<float>(), MIN_V, MAX_V) };
+  float const P2{ m_inputs[3].get<float>() };
+  float const V2{ std::clamp(m_inputs[4].get<float>(), MIN_V, MAX_V) };
 
   float const ABS_DELTA_P{ std::abs(P1 - P2) };
   float const SQRT_ABS_DELTA_P{ std::sqrt((2.f / RO) * ABS_DELTA_P) };
   if (P1 - P2 >= 0.f) {
     m_deltaV = SQRT_ABS_DELTA_P;
-    m_outputs[0].value = -(m_deltaP / V1);
-    m_outputs[1].value = m_deltaP / V2;
+    m_outputs[0].set(-(m_deltaP / V1));
+    m_outputs[1].set(m_deltaP / V2);
   } else {
     m_deltaV = -1.f * SQRT_ABS_DELTA_P;
-    m_outputs[0].value = m_deltaP / V1;
-    m_outputs[1].value = -(m_deltaP / V2);
+    m_outputs[0].set(m_deltaP / V1);
+    m_outputs[1].set(-(m_deltaP / V2));
   }
 
   m_deltaP = VALVE * (RO * m_deltaV * m_deltaV) / 2.f * m_deltaS;
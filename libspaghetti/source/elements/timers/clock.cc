@@ -27,6 +27,8 @@ namespace spaghetti::elements::timers {
 Clock::Clock()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(0);
   setMaxInputs(0);
   setMinOutputs(1);
@@ -55,8 +57,8 @@ void Clock::update(duration_t const &a_delta)
 {
   m_time += a_delta;
   if (m_time >= m_duration) {
-    bool const VALUE = !std::get<bool>(m_outputs[0].value);
-    m_outputs[0].value = VALUE;
+    bool const VALUE = !m_outputs[0].get<bool>();
+    m_outputs[0].set(VALUE);
     reset();
   }
 }
@@ -27,6 +27,8 @@ namespace spaghetti::elements::timers {
 DeltaTime::DeltaTime()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(0);
   setMaxInputs(0);
   setMinOutputs(2);
@@ -39,8 +41,8 @@ DeltaTime::DeltaTime()
 void DeltaTime::update(duration_t const &a_delta)
 {
   m_delta = a_delta;
-  m_outputs[0].value = static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_delta).count());
-  m_outputs[1].value = static_cast<float>(m_delta.count()) / 1000.f;
+  m_outputs[0].set(static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_delta).count()));
+  m_outputs[1].set(static_cast<float>(m_delta.count()) / 1000.f);
 }
 
 } // namespace spaghetti::elements::timers
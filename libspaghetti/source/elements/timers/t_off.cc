@@ -28,6 +28,8 @@ namespace spaghetti::elements::timers {
 TimerOff::TimerOff()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(2);
   setMaxInputs(2);
   setMinOutputs(2);
@@ -50,8 +52,8 @@ void TimerOff::update(duration_t const &a_delta)
 
 void TimerOff::calculate()
 {
-  bool const INPUT = std::get<bool>(m_inputs[0].value);
-  int32_t const PRESET_MS = std::get<int32_t>(m_inputs[1].value);
+  bool const INPUT = m_inputs[0].get<bool>();
+  int32_t const PRESET_MS = m_inputs[1].get<int32_t>();
   duration_t const PRESET = duration_t{ PRESET_MS };
 
   if (PRESET != m_presetTime) m_presetTime = PRESET;
@@ -64,19 +66,19 @@ void TimerOff::calculate()
   switch (m_state) {
     case State::eWaitForTrigger: break;
     case State::eRun:
-      m_outputs[0].value = true;
-      m_outputs[1].value =
-          static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_elapsedTime).count());
+      m_outputs[0].set(true);
+      m_outputs[1].set(
+          static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_elapsedTime).count()));
       break;
     case State::eDone:
-      m_outputs[0].value = false;
-      m_outputs[1].value =
-          static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_elapsedTime).count());
+      m_outputs[0].set(false);
+      m_outputs[1].set(
+          static_cast<int32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(m_elapsedTime).count()));
       break;
     case State::eReset:
       m_elapsedTime = duration_t{ 0 };
-      m_outputs[0].value = false;
-      m_outputs[1].value = 0;
+      m_outputs[0].set(false);
+      m_outputs[1].set(0);
       m_state = State::eWaitForTrigger;
       break;
   }
@@ -47,10 +47,10 @@ BCDToSevenSegmentDisplay::BCDToSevenSegmentDisplay()
 
 void BCDToSevenSegmentDisplay::calculate()
 {
-  int32_t const A{ static_cast<int32_t>(std::get<bool>(m_inputs[0].value)) };
-  int32_t const B{ static_cast<int32_t>(std::get<bool>(m_inputs[1].value)) };
-  int32_t const C{ static_cast<int32_t>(std::get<bool>(m_inputs[2].value)) };
-  int32_t const D{ static_cast<int32_t>(std::get<bool>(m_inputs[3].value)) };
+  int32_t const A{ static_cast<int32_t>(m_inputs[0].get<bool>()) };
+  int32_t const B{ static_cast<int32_t>(m_inputs[1].get<bool>()) };
+  int32_t const C{ static_cast<int32_t>(m_inputs[2].get<bool>()) };
+  int32_t const D{ static_cast<int32_t>(m_inputs[3].get<bool>()) };
 
   int32_t const VALUE{ (D << 3) | (C << 2) | (B << 1) | A };
 
@@ -72,13 +72,13 @@ void BCDToSevenSegmentDisplay::calculate()
 void BCDToSevenSegmentDisplay::setOutputs(bool const a_A, bool const a_B, bool const a_C, bool const a_D,
                                           bool const a_E, bool const a_F, bool const a_G)
 {
-  m_outputs[0].value = a_A;
-  m_outputs[1].value = a_B;
-  m_outputs[2].value = a_C;
-  m_outputs[3].value = a_D;
-  m_outputs[4].value = a_E;
-  m_outputs[5].value = a_F;
-  m_outputs[6].value = a_G;
+  m_outputs[0].set(a_A);
+  m_outputs[1].set(a_B);
+  m_outputs[2].set(a_C);
+  m_outputs[3].set(a_D);
+  m_outputs[4].set(a_E);
+  m_outputs[5].set(a_F);
+  m_outputs[6].set(a_G);
 }
 
 } // namespace spaghetti::elements::ui
@@ -37,13 +37,15 @@ PushButton::PushButton()
 void PushButton::toggle()
 {
   m_currentValue = !m_currentValue;
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
+  markDirty();
 }
 
 void PushButton::set(bool a_state)
 {
   m_currentValue = a_state;
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
+  markDirty();
 }
 
 } // namespace spaghetti::elements::ui
@@ -37,13 +37,15 @@ ToggleButton::ToggleButton()
 void ToggleButton::toggle()
 {
   m_currentValue = !m_currentValue;
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
+  markDirty();
 }
 
 void ToggleButton::set(bool a_state)
 {
   m_currentValue = a_state;
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
+  markDirty();
 }
 
 } // namespace spaghetti::elements::ui
@@ -45,8 +45,8 @@ void CharacteristicCurve::calculate()
 {
   bool const IN_FLOAT{ m_inputs[0].type == ValueType::eFloat };
   bool const OUT_FLOAT{ m_outputs[0].type == ValueType::eFloat };
-  float const INPUT_VALUE = (IN_FLOAT ? std::get<float>(m_inputs[0].value)
-                                     : static_cast<float>(std::get<int32_t>(m_inputs[0].value)));
+  float const INPUT_VALUE = (IN_FLOAT ? m_inputs[0].get<float>()
+                                     : static_cast<float>(m_inputs[0].get<int32_t>()));
   float const VALUE{ std::clamp(INPUT_VALUE, m_xRange.x, m_xRange.y) };
 
   if (nearly_equal(VALUE, m_lastValue)) return;
@@ -85,9 +85,9 @@ void CharacteristicCurve::calculate()
   m_currentValue.y = value;
 
   if (OUT_FLOAT)
-    m_outputs[0].value = value;
+    m_outputs[0].set(value);
   else
-    m_outputs[0].value = static_cast<int32_t>(value);
+    m_outputs[0].set(static_cast<int32_t>(value));
 }
 
 void CharacteristicCurve::serialize(Json &a_json)
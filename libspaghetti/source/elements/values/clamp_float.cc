@@ -42,11 +42,11 @@ ClampFloat::ClampFloat()
 
 void ClampFloat::calculate()
 {
-  float const MINIMUM{ std::get<float>(m_inputs[0].value) };
-  float const MAXIMUM{ std::get<float>(m_inputs[1].value) };
-  float const VALUE{ std::get<float>(m_inputs[2].value) };
+  float const MINIMUM{ m_inputs[0].get<float>() };
+  float const MAXIMUM{ m_inputs[1].get<float>() };
+  float const VALUE{ m_inputs[2].get<float>() };
 
-  m_outputs[0].value = std::clamp(VALUE, MINIMUM, MAXIMUM);
+  m_outputs[0].set(std::clamp(VALUE, MINIMUM, MAXIMUM));
 }
 
 } // namespace spaghetti::elements::values
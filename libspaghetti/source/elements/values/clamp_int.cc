@@ -42,11 +42,11 @@ ClampInt::ClampInt()
 
 void ClampInt::calculate()
 {
-  int32_t const MINIMUM{ std::get<int32_t>(m_inputs[0].value) };
-  int32_t const MAXIMUM{ std::get<int32_t>(m_inputs[1].value) };
-  int32_t const VALUE{ std::get<int32_t>(m_inputs[2].value) };
+  int32_t const MINIMUM{ m_inputs[0].get<int32_t>() };
+  int32_t const MAXIMUM{ m_inputs[1].get<int32_t>() };
+  int32_t const VALUE{ m_inputs[2].get<int32_t>() };
 
-  m_outputs[0].value = std::clamp(VALUE, MINIMUM, MAXIMUM);
+  m_outputs[0].set(std::clamp(VALUE, MINIMUM, MAXIMUM));
 }
 
 } // namespace spaghetti::elements::values
@@ -49,13 +49,14 @@ void ConstInt::deserialize(Json const &a_json)
   auto const &PROPERTIES = a_json["properties"];
   m_currentValue = PROPERTIES["value"].get<int32_t>();
 
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
 }
 
 void ConstInt::set(int32_t a_value)
 {
   m_currentValue = a_value;
-  m_outputs[0].value = m_currentValue;
+  m_outputs[0].set(m_currentValue);
+  markDirty();
 }
 
 } // namespace spaghetti::elements::values
@@ -39,9 +39,9 @@ Degree2Radian::Degree2Radian()
 
 void Degree2Radian::calculate()
 {
-  float const DEGREE{ std::get<float>(m_inputs[0].value) };
+  float const DEGREE{ m_inputs[0].get<float>() };
 
-  m_outputs[0].value = DEGREE * spaghetti::DEG2RAD;
+  m_outputs[0].set(DEGREE * spaghetti::DEG2RAD);
 }
 
 } // namespace spaghetti::elements::values
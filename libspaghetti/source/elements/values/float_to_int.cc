@@ -38,9 +38,9 @@ Float2Int::Float2Int()
 
 void Float2Int::calculate()
 {
-  float const FLOAT{ std::get<float>(m_inputs[0].value) };
+  float const FLOAT{ m_inputs[0].get<float>() };
 
-  m_outputs[0].value = static_cast<int32_t>(FLOAT);
+  m_outputs[0].set(static_cast<int32_t>(FLOAT));
 }
 
 } // namespace spaghetti::elements::values
@@ -39,10 +39,10 @@ MaxInt::MaxInt()
 
 void MaxInt::calculate()
 {
-  int32_t const A{ std::get<int32_t>(m_inputs[0].value) };
-  int32_t const B{ std::get<int32_t>(m_inputs[1].value) };
+  int32_t const A{ m_inputs[0].get<int32_t>() };
+  int32_t const B{ m_inputs[1].get<int32_t>() };
 
-  m_outputs[0].value = std::max(A, B);
+  m_outputs[0].set(std::max(A, B));
 }
 
 } // namespace spaghetti::elements::values
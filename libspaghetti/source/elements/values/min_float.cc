@@ -39,10 +39,10 @@ MinFloat::MinFloat()
 
 void MinFloat::calculate()
 {
-  float const A{ std::get<float>(m_inputs[0].value) };
-  float const B{ std::get<float>(m_inputs[1].value) };
+  float const A{ m_inputs[0].get<float>() };
+  float const B{ m_inputs[1].get<float>() };
 
-  m_outputs[0].value = std::min(A, B);
+  m_outputs[0].set(std::min(A, B));
 }
 
 } // namespace spaghetti::elements::values
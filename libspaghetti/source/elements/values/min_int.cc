@@ -39,10 +39,10 @@ MinInt::MinInt()
 
 void MinInt::calculate()
 {
-  int32_t const A{ std::get<int32_t>(m_inputs[0].value) };
-  int32_t const B{ std::get<int32_t>(m_inputs[1].value) };
+  int32_t const A{ m_inputs[0].get<int32_t>() };
+  int32_t const B{ m_inputs[1].get<int32_t>() };
 
-  m_outputs[0].value = std::min(A, B);
+  m_outputs[0].set(std::min(A, B));
 }
 
 } // namespace spaghetti::elements::values
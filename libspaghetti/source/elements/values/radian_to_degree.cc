@@ -39,9 +39,9 @@ Radian2Degree::Radian2Degree()
 
 void Radian2Degree::calculate()
 {
-  float const RADIAN{ std::get<float>(m_inputs[0].value) };
+  float const RADIAN{ m_inputs[0].get<float>() };
 
-  m_outputs[0].value = RADIAN * spaghetti::RAD2DEG;
+  m_outputs[0].set(RADIAN * spaghetti::RAD2DEG);
 }
 
 } // namespace spaghetti::elements::values
@@ -25,9 +25,9 @@
 #include <spaghetti/elements/values/random_bool.h>
 
 namespace {
-std::random_device g_random{};
-std::mt19937 g_generator{ g_random() };
-std::bernoulli_distribution g_distrib(0.5);
+thread_local std::random_device g_random{};
+thread_local std::mt19937 g_generator{ g_random() };
+thread_local std::bernoulli_distribution g_distrib(0.5);
 } // namespace
 
 namespace spaghetti::elements::values {
@@ -47,11 +47,11 @@ RandomBool::RandomBool()
 
 void RandomBool::calculate()
 {
-  bool const STATE{ std::get<bool>(m_inputs[0].value) };
+  bool const STATE{ m_inputs[0].get<bool>() };
 
   if (STATE != m_state) {
     bool const VALUE{ g_distrib(g_generator) };
-    m_outputs[0].value = VALUE;
+    m_outputs[0].set(VALUE);
     m_state = STATE;
   }
 }
@@ -23,8 +23,8 @@
 #include <spaghetti/elements/values/random_float.h>
 
 namespace {
-std::random_device g_random{};
-std::mt19937 g_generator{ g_random() };
+thread_local std::random_device g_random{};
+thread_local std::mt19937 g_generator{ g_random() };
 } // namespace
 
 namespace spaghetti::elements::values {
@@ -64,11 +64,11 @@ void RandomFloat::deserialize(Json const &a_json)
 
 void RandomFloat::calculate()
 {
-  bool const STATE{ std::get<bool>(m_inputs[0].value) };
+  bool const STATE{ m_inputs[0].get<bool>() };
 
   if (STATE != m_state && STATE) {
     float const VALUE{ m_distrib(g_generator) };
-    m_outputs[0].value = VALUE;
+    m_outputs[0].set(VALUE);
   }
   m_state = STATE;
 }
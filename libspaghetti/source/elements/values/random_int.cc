@@ -23,8 +23,8 @@
 #include <spaghetti/elements/values/random_int.h>
 
 namespace {
-std::random_device g_random{};
-std::mt19937 g_generator{ g_random() };
+thread_local std::random_device g_random{};
+thread_local std::mt19937 g_generator{ g_random() };
 } // namespace
 
 namespace spaghetti::elements::values {
@@ -64,11 +64,11 @@ void RandomInt::deserialize(Json const &a_json)
 
 void RandomInt::calculate()
 {
-  bool const STATE{ std::get<bool>(m_inputs[0].value) };
+  bool const STATE{ m_inputs[0].get<bool>() };
 
   if (STATE != m_state && STATE) {
     int32_t const VALUE{ m_distrib(g_generator) };
-    m_outputs[0].value = VALUE;
+    m_outputs[0].set(VALUE);
   }
   m_state = STATE;
 }
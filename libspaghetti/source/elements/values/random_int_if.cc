@@ -23,8 +23,8 @@
 #include <spaghetti/elements/values/random_int_if.h>
 
 namespace {
-std::random_device g_random{};
-std::mt19937 g_generator{ g_random() };
+thread_local std::random_device g_random{};
+thread_local std::mt19937 g_generator{ g_random() };
 } // namespace
 
 namespace spaghetti::elements::values {
@@ -32,6 +32,8 @@ namespace spaghetti::elements::values {
 RandomIntIf::RandomIntIf()
   : Element{}
 {
+  setTimeDriven(true);
+
   setMinInputs(3);
   setMaxInputs(3);
 
@@ -81,9 +83,9 @@ void RandomIntIf::update(duration_t const &a_delta)
 
 void RandomIntIf::calculate()
 {
-  bool const ENABLED{ std::get<bool>(m_inputs[0].value) };
-  int32_t const ENABLED_INTERVAL{ std::get<int32_t>(m_inputs[1].value) };
-  int32_t const DISABLED_INTERVAL{ std::get<int32_t>(m_inputs[2].value) };
+  bool const ENABLED{ m_inputs[0].get<bool>() };
+  int32_t const ENABLED_INTERVAL{ m_inputs[1].get<int32_t>() };
+  int32_t const DISABLED_INTERVAL{ m_inputs[2].get<int32_t>() };
 
   if (ENABLED != m_enabled) m_elapsed = duration_t{};
 
@@ -91,7 +93,7 @@ void RandomIntIf::calculate()
   m_enabledInterval = duration_t{ ENABLED_INTERVAL };
   m_disabledInterval = duration_t{ DISABLED_INTERVAL };
 
-  m_outputs[0].value = m_value;
+  m_outputs[0].set(m_value);
 }
 
 } // namespace spaghetti::elements::values
@@ -0,0 +1,103 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "mapped_file.h"
+
+// clang-format off
+#if defined(_WIN64) || defined(_WIN32)
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#elif defined(__unix__)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+// clang-format on
+
+#include "spaghetti/logger.h"
+
+namespace spaghetti {
+
+MappedFile::MappedFile(std::string const &a_filename)
+  : m_filename{ a_filename }
+{
+#if defined(_WIN64) || defined(_WIN32)
+  HANDLE const FILE{ CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr) };
+  if (FILE == INVALID_HANDLE_VALUE) {
+    log::error("[mapped_file]: Can't open {}", m_filename);
+    return;
+  }
+  m_file = FILE;
+
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(FILE, &size) || size.QuadPart == 0) return;
+
+  HANDLE const MAPPING{ CreateFileMappingA(FILE, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+  if (MAPPING == nullptr) {
+    log::error("[mapped_file]: CreateFileMapping failed for {}", m_filename);
+    return;
+  }
+  m_mapping = MAPPING;
+
+  m_data = MapViewOfFile(MAPPING, FILE_MAP_READ, 0, 0, 0);
+  if (m_data == nullptr) {
+    log::error("[mapped_file]: MapViewOfFile failed for {}", m_filename);
+    return;
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+#elif defined(__unix__)
+  int const FD{ open(a_filename.c_str(), O_RDONLY) };
+  if (FD == -1) {
+    log::error("[mapped_file]: Can't open {}", m_filename);
+    return;
+  }
+
+  struct stat status {};
+  if (fstat(FD, &status) == 0 && status.st_size > 0) {
+    void *const DATA{ mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, FD, 0) };
+    if (DATA == MAP_FAILED)
+      log::error("[mapped_file]: mmap failed for {}", m_filename);
+    else {
+      m_data = DATA;
+      m_size = static_cast<size_t>(status.st_size);
+    }
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(FD);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(_WIN64) || defined(_WIN32)
+  if (m_data) UnmapViewOfFile(m_data);
+  if (m_mapping) CloseHandle(static_cast<HANDLE>(m_mapping));
+  if (m_file) CloseHandle(static_cast<HANDLE>(m_file));
+#elif defined(__unix__)
+  if (m_data) munmap(m_data, m_size);
+#endif
+}
+
+} // namespace spaghetti
@@ -0,0 +1,58 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_MAPPED_FILE_H
+#define SPAGHETTI_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace spaghetti {
+
+// Read-only view of a whole file mapped into memory.
+class MappedFile final {
+ public:
+  explicit MappedFile(std::string const &a_filename);
+  ~MappedFile();
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  bool isOpen() const { return m_data != nullptr; }
+
+  char const *data() const { return static_cast<char const *>(m_data); }
+  size_t size() const { return m_size; }
+
+ private:
+  std::string m_filename{};
+  void *m_data{};
+  size_t m_size{};
+#if defined(_WIN64) || defined(_WIN32)
+  void *m_file{};
+  void *m_mapping{};
+#endif
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_MAPPED_FILE_H
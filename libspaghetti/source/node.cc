@@ -117,6 +117,7 @@ void Node::paint(QPainter *a_painter, QStyleOptionGraphicsItem const *a_option,
   (void)a_widget;
 
   paintBorder(a_painter);
+  if (isLowDetail(a_painter)) return;
   if (!m_centralWidget || !m_centralWidget->isVisible()) paintIcon(a_painter);
 }
 
@@ -184,11 +185,17 @@ void Node::advance(int a_phase)
 {
   if (!a_phase) return;
 
+  refreshSignals();
+}
+
+void Node::refreshSignals()
+{
+  // Sockets, links and central widgets repaint themselves when what they show changes.
   updateOutputs();
 
   refreshCentralWidget();
 
-  update();
+  for (auto const output : m_outputs) output->animateLinks();
 }
 
 void Node::updateRotation(){
@@ -347,7 +354,8 @@ void Node::paintBorder(QPainter *const a_painter)
   a_painter->setBrush(brush);
   a_painter->drawRect(rect);
 
-  if (m_showName) {
+  bool const LOW_DETAIL{ isLowDetail(a_painter) };
+  if (m_showName && !LOW_DETAIL) {
     QRectF nameRect{ 0.0, 0.0, m_boundingRect.width(), ROUNDED_SOCKET_SIZE };
     pen.setColor(get_color(Color::eFontName));
     QColor nameBackground{ get_color(Color::eNameBackground) };
@@ -851,6 +859,11 @@ void Node::setSocketType(IOSocketsType const a_socketType, uint8_t const a_socke
   socket->setValueType(a_type);
 }
 
+SnapshotBuffer::Snapshot const *Node::snapshot() const
+{
+  return m_packageView ? m_packageView->snapshot() : nullptr;
+}
+
 void Node::updateOutputs()
 {
   if (!m_element || m_type == Type::eOutputs) return;
@@ -862,7 +875,7 @@ void Node::updateOutputs()
   for (size_t i = 0; i < SIZE; ++i) {
     switch (ELEMENT_IOS[i].type) {
       case ValueType::eBool: {
-        bool const SIGNAL{ std::get<bool>(ELEMENT_IOS[i].value) };
+        bool const SIGNAL{ signal<bool>(ELEMENT_IOS[i]) };
         NODE_IOS[static_cast<int>(i)]->setSignal(SIGNAL);
         break;
       }
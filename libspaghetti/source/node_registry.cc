@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spaghetti/node_registry.h"
+
+#include <spaghetti/elements/all.h>
+#include "nodes/all.h"
+
+inline void init_resources()
+{
+  Q_INIT_RESOURCE(icons);
+}
+
+namespace spaghetti {
+
+NodeRegistry &NodeRegistry::get()
+{
+  static NodeRegistry s_registry{};
+  return s_registry;
+}
+
+void NodeRegistry::registerInternalNodes()
+{
+  init_resources();
+
+  using namespace elements;
+
+  registerNode<Package, nodes::Package>();
+
+  registerNode<logic::Blinker, nodes::logic::Blinker>();
+
+  registerNode<pneumatic::Tank, nodes::pneumatic::Tank>();
+
+  registerNode<timers::Clock, nodes::timers::Clock>();
+
+  registerNode<ui::FloatInfo, nodes::ui::FloatInfo>();
+  registerNode<ui::IntInfo, nodes::ui::IntInfo>();
+  registerNode<ui::PushButton, nodes::ui::PushButton>();
+  registerNode<ui::ToggleButton, nodes::ui::ToggleButton>();
+  registerNode<ui::SevenSegmentDisplay, nodes::ui::SevenSegmentDisplay>();
+
+  registerNode<values::ConstBool, nodes::values::ConstBool>();
+  registerNode<values::ConstFloat, nodes::values::ConstFloat>();
+  registerNode<values::ConstInt, nodes::values::ConstInt>();
+  registerNode<values::RandomFloat, nodes::values::RandomFloat>();
+  registerNode<values::RandomFloatIf, nodes::values::RandomFloatIf>();
+  registerNode<values::RandomInt, nodes::values::RandomInt>();
+  registerNode<values::RandomIntIf, nodes::values::RandomIntIf>();
+
+#ifdef SPAGHETTI_USE_CHARTS
+  registerNode<values::CharacteristicCurve, nodes::values::CharacteristicCurve>();
+#endif
+}
+
+Node *NodeRegistry::createNode(string::hash_t const a_hash)
+{
+  auto const IT = m_nodes.find(a_hash);
+  if (IT == m_nodes.end()) return new Node;
+  return IT->second();
+}
+
+bool NodeRegistry::hasNode(string::hash_t const a_hash) const
+{
+  return m_nodes.find(a_hash) != m_nodes.end();
+}
+
+} // namespace spaghetti
@@ -48,9 +48,11 @@ FloatInfo::FloatInfo()
 void FloatInfo::refreshCentralWidget()
 {
   if (!m_element) return;
-  float const value{ std::get<float>(m_element->inputs()[0].value) };
-  m_info->setText(QString::number(static_cast<qreal>(value), 'f', 8));
+  float const value{ signal<float>(m_element->inputs()[0]) };
+  QString const TEXT{ QString::number(static_cast<qreal>(value), 'f', 8) };
+  if (TEXT == m_info->text()) return;
 
+  m_info->setText(TEXT);
   calculateBoundingRect();
 }
 
@@ -48,9 +48,11 @@ IntInfo::IntInfo()
 void IntInfo::refreshCentralWidget()
 {
   if (!m_element) return;
-  int32_t const value{ std::get<int32_t>(m_element->inputs()[0].value) };
-  m_info->setText(QString::number(value));
+  int32_t const value{ signal<int32_t>(m_element->inputs()[0]) };
+  QString const TEXT{ QString::number(value) };
+  if (TEXT == m_info->text()) return;
 
+  m_info->setText(TEXT);
   calculateBoundingRect();
 }
 
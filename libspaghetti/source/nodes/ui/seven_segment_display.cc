@@ -73,7 +73,12 @@ class SevenSegmentDisplayWidget : public QGraphicsItem {
     a_painter->drawEllipse(m_segments[7].boundingRect());
   }
 
-  void setState(size_t const a_index, bool const a_value) { m_states[a_index] = a_value; }
+  void setState(size_t const a_index, bool const a_value)
+  {
+    if (m_states[a_index] == a_value) return;
+    m_states[a_index] = a_value;
+    update();
+  }
 
  private:
   void createSegments()
@@ -131,14 +136,14 @@ void SevenSegmentDisplay::refreshCentralWidget()
 
   auto const &inputs = m_element->inputs();
 
-  bool const A{ std::get<bool>(inputs[0].value) };
-  bool const B{ std::get<bool>(inputs[1].value) };
-  bool const C{ std::get<bool>(inputs[2].value) };
-  bool const D{ std::get<bool>(inputs[3].value) };
-  bool const E{ std::get<bool>(inputs[4].value) };
-  bool const F{ std::get<bool>(inputs[5].value) };
-  bool const G{ std::get<bool>(inputs[6].value) };
-  bool const DP{ std::get<bool>(inputs[7].value) };
+  bool const A{ signal<bool>(inputs[0]) };
+  bool const B{ signal<bool>(inputs[1]) };
+  bool const C{ signal<bool>(inputs[2]) };
+  bool const D{ signal<bool>(inputs[3]) };
+  bool const E{ signal<bool>(inputs[4]) };
+  bool const F{ signal<bool>(inputs[5]) };
+  bool const G{ signal<bool>(inputs[6]) };
+  bool const DP{ signal<bool>(inputs[7]) };
 
   m_widget->setState(0, A);
   m_widget->setState(1, B);
@@ -148,8 +153,6 @@ void SevenSegmentDisplay::refreshCentralWidget()
   m_widget->setState(5, F);
   m_widget->setState(6, G);
   m_widget->setState(7, DP);
-
-  calculateBoundingRect();
 }
 
 void SevenSegmentDisplay::showProperties()
@@ -80,7 +80,6 @@ void CharacteristicCurve::refreshCentralWidget()
   if (!m_element) return;
 
   updateCurrentValue(false);
-  calculateBoundingRect();
 }
 
 void CharacteristicCurve::showProperties()
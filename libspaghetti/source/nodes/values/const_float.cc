@@ -50,9 +50,11 @@ ConstFloat::ConstFloat()
 void ConstFloat::refreshCentralWidget()
 {
   if (!m_element) return;
-  float const VALUE{ std::get<float>(m_element->outputs()[0].value) };
-  m_info->setText(QString::number(static_cast<qreal>(VALUE), 'f', 4));
+  float const VALUE{ signal<float>(m_element->outputs()[0]) };
+  QString const TEXT{ QString::number(static_cast<qreal>(VALUE), 'f', 4) };
+  if (TEXT == m_info->text()) return;
 
+  m_info->setText(TEXT);
   calculateBoundingRect();
 }
 
@@ -48,9 +48,11 @@ ConstInt::ConstInt()
 void ConstInt::refreshCentralWidget()
 {
   if (!m_element) return;
-  int32_t const VALUE{ std::get<int32_t>(m_element->outputs()[0].value) };
-  m_info->setText(QString::number(VALUE));
+  int32_t const VALUE{ signal<int32_t>(m_element->outputs()[0]) };
+  QString const TEXT{ QString::number(VALUE) };
+  if (TEXT == m_info->text()) return;
 
+  m_info->setText(TEXT);
   calculateBoundingRect();
 }
 
@@ -20,30 +20,78 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <set>
 #include <string_view>
+#include <tuple>
+#include <unordered_map>
 
 #include "spaghetti/package.h"
 
+#include "spaghetti/binary_package.h"
 #include "spaghetti/logger.h"
 #include "spaghetti/registry.h"
+#include "arena.h"
+#include "edit_queue.h"
+#include "worker_pool.h"
 
 namespace spaghetti {
 
+namespace {
+// Smaller levels are cheaper to run inline than to hand over to the worker pool.
+constexpr size_t const MIN_PARALLEL_STEPS{ 64 };
+
+bool isBinaryFilename(std::string_view const a_filename)
+{
+  std::string_view const EXTENSION{ BinaryPackage::EXTENSION };
+  return a_filename.size() >= EXTENSION.size() &&
+         a_filename.substr(a_filename.size() - EXTENSION.size()) == EXTENSION;
+}
+
+// Bitwise, so a NaN that stays NaN isn't a change every tick.
+bool isSameValue(Element::Value const &a_lhs, Element::Value const &a_rhs)
+{
+  if (a_lhs.index() != a_rhs.index()) return false;
+  return std::visit(
+    [&a_rhs](auto const a_held) {
+      auto const OTHER = std::get<std::decay_t<decltype(a_held)>>(a_rhs);
+      return std::memcmp(&a_held, &OTHER, sizeof(a_held)) == 0;
+    },
+    a_lhs);
+}
+} // namespace
+
 Package::Package()
   : Element{}
+  , m_arena{ std::make_unique<Arena>() }
+  , m_edits{ std::make_unique<EditQueue>() }
 {
-  m_elements.push_back(this);
+  m_slots.push_back(Slot{ this, 0, 0 });
 
+  setTimeDriven(true);
   setDefaultNewInputFlags(IOSocket::eDefaultFlags);
   setDefaultNewOutputFlags(IOSocket::eDefaultFlags);
 }
 
 Package::~Package()
 {
-  size_t const SIZE{ m_elements.size() };
-  for (size_t i = 1; i < SIZE; ++i) delete m_elements[i];
+  for (auto const element : m_elements) destroy(element);
+}
+
+void Package::destroy(Element *const a_element)
+{
+  // Elements are constructed in place, the arena wants the address of the whole object back.
+  auto const memory = dynamic_cast<void *>(a_element);
+  a_element->~Element();
+  m_arena->release(memory);
 }
 
 void Package::serialize(Element::Json &a_json)
@@ -62,27 +110,29 @@ void Package::serialize(Element::Json &a_json)
   jsonPackage["icon"] = m_packageIcon;
 
   if (!m_isExternal) {
-    auto jsonElements = Json::array();
-    // TODO(aljen): fix holes
-    size_t const DATA_SIZE{ m_elements.size() };
-    for (size_t i = 1; i < DATA_SIZE; ++i) {
-      auto const element = m_elements[i];
-      if (element == nullptr) continue;
+    // Saved ids are dense, holes left by removed elements don't reach the file.
+    std::vector<size_t> savedIds(m_slots.size());
+    for (size_t i = 0; i < m_elements.size(); ++i) savedIds[m_elements[i]->m_id] = i + 1;
 
+    auto jsonElements = Json::array();
+    for (auto const element : m_elements) {
       Json jsonElement{};
       element->serialize(jsonElement);
+      jsonElement["element"]["id"] = savedIds[element->m_id];
       jsonElements.push_back(jsonElement);
     }
     jsonPackage["elements"] = jsonElements;
 
     auto jsonConnections = Json::array();
     for (auto const &CONNECTION : m_connections) {
+      if (!contains(CONNECTION.from_id) || !contains(CONNECTION.to_id)) continue;
+
       Json jsonConnection{}, jsonConnect{}, jsonTo{};
 
-      jsonConnect["id"] = CONNECTION.from_id;
+      jsonConnect["id"] = savedIds[CONNECTION.from_id];
       jsonConnect["socket"] = CONNECTION.from_socket;
       jsonConnect["flags"] = CONNECTION.from_flags;
-      jsonTo["id"] = CONNECTION.to_id;
+      jsonTo["id"] = savedIds[CONNECTION.to_id];
       jsonTo["socket"] = CONNECTION.to_socket;
       jsonTo["flags"] = CONNECTION.to_flags;
 
@@ -95,6 +145,19 @@ void Package::serialize(Element::Json &a_json)
 }
 
 void Package::deserialize(Json const &a_json)
+{
+  deserializeHeader(a_json);
+
+  if (m_isExternal) {
+    loadExternal(m_packagePath);
+    return;
+  }
+
+  RemappedIds remappedIds{};
+  loadContent(a_json["package"], remappedIds);
+}
+
+void Package::deserializeHeader(Json const &a_json)
 {
   auto const IS_ROOT = m_package == nullptr;
   Element::deserialize(a_json,IS_ROOT);
@@ -117,246 +180,1055 @@ void Package::deserialize(Json const &a_json)
 
   spaghetti::log::debug("deserialize root? {} isExternal? {}", IS_ROOT, m_isExternal);
 
-  Json json{};
+  setPackageDescription(DESCRIPTION);
+  setPackageIcon(ICON);
+  setPackagePath(PATH);
+  setInputsPosition(INPUTS_POSITION_X, INPUTS_POSITION_Y);
+  setOutputsPosition(OUTPUTS_POSITION_X, OUTPUTS_POSITION_Y);
+}
 
-  if (m_isExternal) {
-    log::debug("Package is external one, looking for real one registered as '{}'", PATH);
+void Package::restore(BinaryPackage const &a_file, uint32_t const a_element)
+{
+  auto const IS_ROOT = m_package == nullptr;
+  Element::restore(a_file, a_element);
 
-    auto const &REGISTRY = Registry::get();
-    auto const &PACKAGES = REGISTRY.packages();
+  auto const PACKAGE_INDEX = a_file.element(a_element).package;
+  if (PACKAGE_INDEX == BinaryPackage::NONE) return;
 
-    std::string filename{};
+  auto const &PACKAGE = a_file.package(PACKAGE_INDEX);
+  std::string const PATH{ a_file.string(PACKAGE.path) };
 
-    for (auto const &PACKAGE_INFO : PACKAGES) {
-      if (PACKAGE_INFO.second.path == PATH || PACKAGE_INFO.second.filename == PATH) {
-        filename = PACKAGE_INFO.second.filename;
-        log::debug("Found one, '{}' is at '{}'", PATH, filename);
-        break;
-      }
-    }
+  m_isExternal = !IS_ROOT && !PATH.empty();
 
-    assert(!filename.empty() && "Can't find external package");
+  spaghetti::log::debug("restore root? {} isExternal? {}", IS_ROOT, m_isExternal);
 
-    std::ifstream file{ filename };
-    if (!file.is_open()) return;
+  setPackageDescription(std::string{ a_file.string(PACKAGE.description) });
+  setPackageIcon(std::string{ a_file.string(PACKAGE.icon) });
+  setPackagePath(PATH);
+  setInputsPosition(PACKAGE.inputsPosition[0], PACKAGE.inputsPosition[1]);
+  setOutputsPosition(PACKAGE.outputsPosition[0], PACKAGE.outputsPosition[1]);
 
-    file >> json;
-  }
+  if (m_isExternal)
+    loadExternal(PATH);
+  else
+    loadContent(a_file, PACKAGE_INDEX);
+}
 
-  auto const &REAL_PACKAGE = m_isExternal ? json["package"] : PACKAGE;
-  auto const &ELEMENTS = REAL_PACKAGE["elements"];
-  auto const &CONNECTIONS = REAL_PACKAGE["connections"];
+void Package::loadExternal(std::string const &a_path)
+{
+  log::debug("Package is external one, looking for real one registered as '{}'", a_path);
 
-  setPackageDescription(DESCRIPTION);
-  setPackageIcon(ICON);
-  setPackagePath(PATH);
-  setInputsPosition(INPUTS_POSITION_X, INPUTS_POSITION_Y);
-  setOutputsPosition(OUTPUTS_POSITION_X, OUTPUTS_POSITION_Y);
+  auto const DEFINITION = Registry::get().packageDefinition(a_path);
+  assert(DEFINITION && "Can't find external package");
+  if (!DEFINITION) return;
 
-  std::map<size_t, size_t> remappedIds{};
+  log::debug("Found one, '{}' is at '{}'", a_path, DEFINITION->filename);
 
-  for (auto const &TEMP : ELEMENTS) {
-    auto const &ELEMENT_GROUP = TEMP["element"];
-    auto const ELEMENT_TYPE = ELEMENT_GROUP["type"].get<std::string>();
-    auto const element = add(ELEMENT_TYPE.c_str());
-    auto const ELEMENT_ID = ELEMENT_GROUP["id"].get<size_t>();
-    auto const ADDED_ID = element->id();
-    element->deserialize(TEMP);
+  loadContent(*DEFINITION->binary, DEFINITION->binary->element(0).package);
+}
 
-    remappedIds[ELEMENT_ID] = ADDED_ID;
-  }
+void Package::loadElement(Json const &a_element, RemappedIds &a_remappedIds)
+{
+  auto const &ELEMENT_GROUP = a_element["element"];
+  auto const ELEMENT_TYPE = ELEMENT_GROUP["type"].get<std::string>();
+  auto const element = add(ELEMENT_TYPE.c_str());
+  auto const ELEMENT_ID = ELEMENT_GROUP["id"].get<size_t>();
+  auto const ADDED_ID = element->id();
+  element->deserialize(a_element);
+
+  a_remappedIds[ELEMENT_ID] = ADDED_ID;
+}
+
+void Package::loadContent(Json const &a_package, RemappedIds &a_remappedIds)
+{
+  auto const &ELEMENTS = a_package["elements"];
+  auto const &CONNECTIONS = a_package["connections"];
+
+  for (auto const &ELEMENT : ELEMENTS) loadElement(ELEMENT, a_remappedIds);
 
   for (auto const &CONNECTION : CONNECTIONS) {
     auto const &FROM = CONNECTION["connect"];
     auto const &TO = CONNECTION["to"];
-    auto const &FROM_ID = remappedIds[FROM["id"].get<size_t>()];
+    auto const &FROM_ID = a_remappedIds[FROM["id"].get<size_t>()];
     auto const &FROM_SOCKET = FROM["socket"].get<uint8_t>();
     auto const &FROM_FLAGS = (FROM["flags"]!=NULL)?FROM["flags"].get<uint8_t>():0;
-    auto const &TO_ID = remappedIds[TO["id"].get<size_t>()];
+    auto const &TO_ID = a_remappedIds[TO["id"].get<size_t>()];
     auto const &TO_SOCKET = TO["socket"].get<uint8_t>();
     auto const &TO_FLAGS = (TO["flags"]!=NULL)?TO["flags"].get<uint8_t>():0;
     connect(FROM_ID, FROM_SOCKET, FROM_FLAGS, TO_ID, TO_SOCKET, TO_FLAGS);
   }
 }
 
+void Package::loadContent(BinaryPackage const &a_file, uint32_t const a_package)
+{
+  auto const &PACKAGE = a_file.package(a_package);
+
+  RemappedIds remappedIds{};
+
+  for (uint32_t i = 0; i < PACKAGE.elementCount; ++i) {
+    uint32_t const INDEX{ PACKAGE.firstElement + i };
+    auto const &RECORD = a_file.element(INDEX);
+    auto const element = add(a_file.c_str(RECORD.type));
+
+    if (RECORD.propertiesSize != 0)
+      element->deserialize(a_file.elementToJson(INDEX));
+    else
+      element->restore(a_file, INDEX);
+
+    remappedIds[RECORD.id] = element->id();
+  }
+
+  for (uint32_t i = 0; i < PACKAGE.connectionCount; ++i) {
+    auto const &CONNECTION = a_file.connection(PACKAGE.firstConnection + i);
+    connect(remappedIds[CONNECTION.fromId], CONNECTION.fromSocket, CONNECTION.fromFlags, remappedIds[CONNECTION.toId],
+            CONNECTION.toSocket, CONNECTION.toFlags);
+  }
+}
+
 void Package::calculate()
 {
+  if (!m_package) applyEdits();
+
+  if (m_scheduleDirty) compileSchedule();
+
+  bool const DIRTY_ONLY{ m_evaluationMode == EvaluationMode::eDirtyOnly };
+  if (DIRTY_ONLY && publish(m_publishedInputs, m_inputs)) markDependentsDirty(0, m_inputDependents);
+
+  for (auto const &COPY : m_feedbackCopies) copy(COPY);
+
+  if (m_workers) {
+    for (auto const &LEVEL : m_levels) {
+      if (LEVEL.parallel)
+        m_workers->run(LEVEL.stepsEnd - LEVEL.stepsBegin, [this, &LEVEL, DIRTY_ONLY](size_t const a_index) {
+          runStep(m_steps[LEVEL.stepsBegin + a_index], DIRTY_ONLY);
+        });
+      else
+        for (size_t i = LEVEL.stepsBegin; i < LEVEL.stepsEnd; ++i) runStep(m_steps[i], DIRTY_ONLY);
+    }
+  } else
+    for (auto &step : m_steps) runStep(step, DIRTY_ONLY);
+
+  for (auto const &COPY : m_outputCopies) copy(COPY);
+}
+
+void Package::runStep(Step &a_step, bool const a_dirtyOnly)
+{
+  auto const element = a_step.element;
+  if (a_dirtyOnly && !element->m_dirty.exchange(false) && !element->m_timeDriven) return;
 
+  for (size_t i = a_step.copiesBegin; i < a_step.copiesEnd; ++i) copy(m_copies[i]);
 
-  for (auto &&connection : m_connections) {
-    Element *const source{ get(connection.from_id) };
-    Element *const target{ get(connection.to_id) };
+  element->update(m_delta);
+  element->calculate();
 
-    auto const IS_SOURCE_SELF = connection.from_id == 0;
-    auto const IS_TARGET_SELF = connection.to_id == 0;
-//&& connection.from_flags != 2
-    //spaghetti::log::info("conn from {}@{}@{}",connection.from_id,connection.from_socket,connection.from_flags);
-    //spaghetti::log::info("conn to   {}@{}@{}",connection.to_id,connection.to_socket,connection.to_flags);
-    //IS_SOURCE_SELF ||
-    auto const &SOURCE_IO =  IS_SOURCE_SELF || connection.from_flags != 2  ? source->inputs() : source->outputs();
-    //&& connection.to_flags == 2
-    //IS_TARGET_SELF ||
-    auto &targetIO =  IS_TARGET_SELF || connection.to_flags == 2 ? target->outputs() : target->inputs();
-    //spaghetti::log::info("before write val");
-    targetIO[connection.to_socket].value = SOURCE_IO[connection.from_socket].value;
+  if (a_dirtyOnly && publish(a_step.published, element->m_outputs))
+    markDependentsDirty(a_step.dependentsBegin, a_step.dependentsEnd);
+}
+
+bool Package::publish(std::vector<Value> &a_published, IOSockets const &a_sockets)
+{
+  size_t const SIZE{ a_sockets.size() };
+  bool changed{ a_published.size() != SIZE };
+  if (changed) a_published.resize(SIZE);
+
+  for (size_t i = 0; i < SIZE; ++i) {
+    auto const VALUE = a_sockets[i].value();
+    if (isSameValue(a_published[i], VALUE)) continue;
+    a_published[i] = VALUE;
+    changed = true;
   }
 
-  for (auto &&element : m_elements) {
-    if (!element || element == this) continue;
+  return changed;
+}
+
+void Package::markDependentsDirty(size_t const a_begin, size_t const a_end)
+{
+  for (size_t i = a_begin; i < a_end; ++i) m_dependents[i]->markDirty();
+}
 
-    element->update(m_delta);
-    element->calculate();
+void Package::bindSignals(SignalStore &a_store)
+{
+  invalidateSchedule();
+
+  for (auto const element : m_elements) element->bindSignals(a_store);
+
+  Element::bindSignals(a_store);
+}
+
+void Package::setWorkerThreads(size_t const a_count)
+{
+  pauseDispatchThread();
+
+  m_workers.reset();
+  if (a_count > 1) m_workers = std::make_unique<WorkerPool>(a_count);
+
+  resumeDispatchThread();
+}
+
+size_t Package::workerThreads() const
+{
+  return m_workers ? m_workers->participants() : 1;
+}
+
+void Package::setZeroCopyConnections(bool const a_enabled)
+{
+  pauseDispatchThread();
+
+  m_zeroCopyConnections = a_enabled;
+
+  for (auto const element : m_elements) {
+    if (element->hash() == HASH) static_cast<Package *>(element)->setZeroCopyConnections(a_enabled);
   }
 
+  invalidateSchedule();
+
+  resumeDispatchThread();
 }
 
-Element *Package::add(string::hash_t const a_hash)
+void Package::setFlattenPackages(bool const a_enabled)
 {
   pauseDispatchThread();
 
-  spaghetti::log::debug("Adding element..");
+  m_flattenPackages = a_enabled;
 
-  spaghetti::Registry &registry{ spaghetti::Registry::get() };
+  for (auto const element : m_elements) {
+    if (element->hash() == HASH) static_cast<Package *>(element)->setFlattenPackages(a_enabled);
+  }
 
-  Element *const element{ registry.createElement(a_hash) };
-  assert(element);
+  invalidateSchedule();
 
+  resumeDispatchThread();
+}
+
+void Package::setEvaluationMode(EvaluationMode const a_mode)
+{
+  pauseDispatchThread();
+
+  m_evaluationMode = a_mode;
+
+  for (auto const element : m_elements) {
+    if (element->hash() == HASH) static_cast<Package *>(element)->setEvaluationMode(a_mode);
+  }
+
+  invalidateSchedule();
+
+  resumeDispatchThread();
+}
+
+void Package::copy(Copy const &a_copy)
+{
+  auto const &SOURCE_IO = a_copy.sourceIsOutput ? a_copy.source->outputs() : a_copy.source->inputs();
+  auto &targetIO = a_copy.targetIsOutput ? a_copy.target->outputs() : a_copy.target->inputs();
+  auto const &SOURCE = SOURCE_IO[a_copy.sourceSocket];
+  auto &target = targetIO[a_copy.targetSocket];
+  assert(SOURCE.store == target.store);
+  target.store->copy(SOURCE.handle, target.handle);
+}
+
+void Package::collectGraph(Elements &a_nodes, Copies &a_copies) const
+{
+  for (auto const &CONNECTION : m_connections) {
+    if (!contains(CONNECTION.from_id) || !contains(CONNECTION.to_id)) continue;
+
+    auto const IS_SOURCE_SELF = CONNECTION.from_id == 0;
+    auto const IS_TARGET_SELF = CONNECTION.to_id == 0;
+    a_copies.push_back(Copy{ m_slots[CONNECTION.from_id].element, m_slots[CONNECTION.to_id].element, CONNECTION.from_socket,
+                             CONNECTION.to_socket, !IS_SOURCE_SELF && CONNECTION.from_flags == 2,
+                             IS_TARGET_SELF || CONNECTION.to_flags == 2 });
+  }
+
+  // Nested packages come after their parent, so their inner drivers win over outer writes to the same socket.
+  for (auto const element : m_elements) {
+    if (m_flattenPackages && element->hash() == HASH)
+      static_cast<Package const *>(element)->collectGraph(a_nodes, a_copies);
+    else
+      a_nodes.push_back(element);
+  }
+}
+
+void Package::compileSchedule()
+{
+  restoreAliases();
+
+  // Node 0 is this package itself, its inputs are sources and its outputs are targets only.
+  Elements nodes{ this };
+  Copies copies{};
+  collectGraph(nodes, copies);
+
+  size_t const SIZE{ nodes.size() };
+  size_t const NO_NODE{ std::numeric_limits<size_t>::max() };
+
+  std::unordered_map<Element const *, size_t> nodeOf{};
+  nodeOf.reserve(SIZE);
+  for (size_t i = 0; i < SIZE; ++i) nodeOf[nodes[i]] = i;
+  auto const nodeIndex = [&nodeOf, NO_NODE](Element const *const a_element) {
+    auto const IT = nodeOf.find(a_element);
+    return IT == nodeOf.end() ? NO_NODE : IT->second;
+  };
+
+  // A flattened package never runs, whatever reads its sockets reads what drives them instead.
+  auto const isBoundary = [this](Element const *const a_element) {
+    return m_flattenPackages && a_element != this && a_element->hash() == HASH;
+  };
+
+  using SocketKey = std::tuple<Element const *, uint8_t, bool>;
+  std::map<SocketKey, Copy> drivers{};
+  for (auto const &COPY : copies)
+    if (isBoundary(COPY.target)) drivers[SocketKey{ COPY.target, COPY.targetSocket, COPY.targetIsOutput }] = COPY;
+
+  auto const resolve = [&drivers, &isBoundary](Copy a_copy) {
+    // Bounded, so boundaries wired into a loop through each other can't hang the compile.
+    for (size_t hops = 0; hops <= drivers.size() && isBoundary(a_copy.source); ++hops) {
+      auto const IT = drivers.find(SocketKey{ a_copy.source, a_copy.sourceSocket, a_copy.sourceIsOutput });
+      if (IT == drivers.end()) break;
+      a_copy.source = IT->second.source;
+      a_copy.sourceSocket = IT->second.sourceSocket;
+      a_copy.sourceIsOutput = IT->second.sourceIsOutput;
+    }
+    return a_copy;
+  };
+
+  Copies resolved{};
+  resolved.reserve(copies.size());
+  std::vector<std::vector<size_t>> successors(SIZE);
+  for (auto const &COPY : copies) {
+    if (isBoundary(COPY.target)) continue;
+
+    resolved.push_back(resolve(COPY));
+
+    auto const FROM = nodeIndex(resolved.back().source);
+    auto const TO = nodeIndex(resolved.back().target);
+    if (FROM == NO_NODE || TO == 0) continue;
+
+    auto &dependents = successors[FROM];
+    if (std::find(std::begin(dependents), std::end(dependents), TO) == std::end(dependents)) dependents.push_back(TO);
+  }
+
+  // Depth-first walk marks every edge closing a feedback loop, so the rest of the graph is acyclic.
+  enum class Mark : uint8_t { eNew, eOpen, eDone };
+  std::vector<Mark> marks(SIZE, Mark::eNew);
+  std::set<std::pair<size_t, size_t>> backEdges{};
+  std::vector<std::pair<size_t, size_t>> stack{};
+
+  for (size_t root = 1; root < SIZE; ++root) {
+    if (marks[root] != Mark::eNew) continue;
+
+    marks[root] = Mark::eOpen;
+    stack.emplace_back(root, 0);
+
+    while (!stack.empty()) {
+      auto const ID = stack.back().first;
+      auto const NEXT = stack.back().second;
+      auto const &DEPENDENCIES = successors[ID];
+
+      if (NEXT >= DEPENDENCIES.size()) {
+        marks[ID] = Mark::eDone;
+        stack.pop_back();
+        continue;
+      }
+
+      stack.back().second++;
+
+      auto const TARGET = DEPENDENCIES[NEXT];
+      if (marks[TARGET] == Mark::eOpen)
+        backEdges.emplace(ID, TARGET);
+      else if (marks[TARGET] == Mark::eNew) {
+        marks[TARGET] = Mark::eOpen;
+        stack.emplace_back(TARGET, 0);
+      }
+    }
+  }
+
+  auto const isBackEdge = [&backEdges](size_t const a_from, size_t const a_to) {
+    return backEdges.find({ a_from, a_to }) != backEdges.end();
+  };
+
+  std::vector<size_t> inDegree(SIZE);
+  for (size_t id = 1; id < SIZE; ++id)
+    for (auto const TARGET : successors[id])
+      if (!isBackEdge(id, TARGET)) inDegree[TARGET]++;
+
+  std::vector<size_t> order{};
+  order.reserve(SIZE);
+  for (size_t id = 1; id < SIZE; ++id)
+    if (inDegree[id] == 0) order.push_back(id);
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    auto const ID = order[i];
+    for (auto const TARGET : successors[ID])
+      if (!isBackEdge(ID, TARGET) && --inDegree[TARGET] == 0) order.push_back(TARGET);
+  }
+
+  // Steps within one level never feed each other, so a level can run in parallel once the previous one is done.
+  std::vector<size_t> levelOf(SIZE);
+  for (auto const ID : order)
+    for (auto const TARGET : successors[ID])
+      if (!isBackEdge(ID, TARGET)) levelOf[TARGET] = std::max(levelOf[TARGET], levelOf[ID] + 1);
+  std::stable_sort(std::begin(order), std::end(order),
+                   [&levelOf](size_t const a_lhs, size_t const a_rhs) { return levelOf[a_lhs] < levelOf[a_rhs]; });
+
+  std::vector<size_t> stepOf(SIZE);
+  for (size_t i = 0; i < order.size(); ++i) stepOf[order[i]] = i;
+
+  std::vector<Copies> fanIn(order.size());
+  m_feedbackCopies.clear();
+  m_outputCopies.clear();
+
+  for (auto const &COPY : resolved) {
+    auto const FROM = nodeIndex(COPY.source);
+    auto const TO = nodeIndex(COPY.target);
+
+    if (TO == 0)
+      m_outputCopies.push_back(COPY);
+    else if (FROM != NO_NODE && FROM != 0 && isBackEdge(FROM, TO))
+      m_feedbackCopies.push_back(COPY);
+    else if (!(m_zeroCopyConnections && alias(COPY)))
+      fanIn[stepOf[TO]].push_back(COPY);
+  }
+
+  // Boundary sockets keep showing their values, refreshed at the end of the tick when they can't alias.
+  for (auto const &DRIVER : drivers) {
+    auto const COPY = resolve(DRIVER.second);
+    if (!forward(COPY)) m_outputCopies.push_back(COPY);
+  }
+
+  m_dependents.clear();
+  for (auto const TARGET : successors[0]) m_dependents.push_back(nodes[TARGET]);
+  m_inputDependents = m_dependents.size();
+
+  m_steps.clear();
+  m_levels.clear();
+  m_copies.clear();
+  m_steps.reserve(order.size());
+  size_t packages{};
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i == 0 || levelOf[order[i]] != levelOf[order[i - 1]]) {
+      m_levels.push_back(Level{ i, i, false });
+      packages = 0;
+    }
+
+    Step step{ nodes[order[i]], m_copies.size(), 0, m_dependents.size(), 0, {} };
+    m_copies.insert(std::end(m_copies), std::begin(fanIn[i]), std::end(fanIn[i]));
+    step.copiesEnd = m_copies.size();
+    for (auto const TARGET : successors[order[i]]) m_dependents.push_back(nodes[TARGET]);
+    step.dependentsEnd = m_dependents.size();
+    step.element->markDirty();
+    m_steps.push_back(std::move(step));
+
+    auto &level = m_levels.back();
+    if (nodes[order[i]]->hash() == HASH) packages++;
+    level.stepsEnd = i + 1;
+    level.parallel = level.stepsEnd - level.stepsBegin >= MIN_PARALLEL_STEPS || packages > 1;
+  }
+  m_publishedInputs.clear();
+
+  m_scheduleDirty = false;
+
+  // Aliases may have rebound sockets anywhere below the root, whose snapshots tell readers about it.
+  Package *root{ this };
+  while (root->m_package) root = root->m_package;
+  root->m_layout++;
+
+  spaghetti::log::debug("Compiled schedule for {}: {} steps in {} levels, {} copies, {} aliases, {} feedback, {} outputs",
+                        name(), m_steps.size(), m_levels.size(), m_copies.size(), m_aliases.size(),
+                        m_feedbackCopies.size(), m_outputCopies.size());
+}
+
+bool Package::alias(Copy const &a_copy)
+{
+  if (!a_copy.sourceIsOutput || a_copy.targetIsOutput) return false;
+
+  auto const &SOURCE = a_copy.source->m_outputs[a_copy.sourceSocket];
+  auto &target = a_copy.target->m_inputs[a_copy.targetSocket];
+  if (SOURCE.store != target.store || SOURCE.handle.type != target.storage.type) return false;
+
+  target.handle = SOURCE.handle;
+  m_aliases.push_back(Alias{ a_copy.target, a_copy.targetSocket, false });
+
+  return true;
+}
+
+bool Package::forward(Copy const &a_copy)
+{
+  auto const &SOURCE = (a_copy.sourceIsOutput ? a_copy.source->m_outputs : a_copy.source->m_inputs)[a_copy.sourceSocket];
+  auto &target = (a_copy.targetIsOutput ? a_copy.target->m_outputs : a_copy.target->m_inputs)[a_copy.targetSocket];
+  if (&SOURCE == &target) return true;
+  if (SOURCE.store != target.store || SOURCE.handle.type != target.storage.type) return false;
+
+  target.handle = SOURCE.handle;
+  m_aliases.push_back(Alias{ a_copy.target, a_copy.targetSocket, a_copy.targetIsOutput });
+
+  return true;
+}
+
+void Package::restoreAliases()
+{
+  for (auto const &ALIAS : m_aliases) {
+    auto &sockets = ALIAS.isOutput ? ALIAS.element->m_outputs : ALIAS.element->m_inputs;
+    if (ALIAS.socket >= sockets.size()) continue;
+
+    auto &socket = sockets[ALIAS.socket];
+    if (socket.handle.type == socket.storage.type && socket.handle.index == socket.storage.index) continue;
+
+    socket.store->copy(socket.handle, socket.storage);
+    socket.handle = socket.storage;
+  }
+
+  m_aliases.clear();
+}
+
+void Package::collectAliases(SnapshotBuffer::Aliases &a_aliases) const
+{
+  for (auto const &ALIAS : m_aliases) {
+    auto const &SOCKETS = ALIAS.isOutput ? ALIAS.element->m_outputs : ALIAS.element->m_inputs;
+    if (ALIAS.socket >= SOCKETS.size()) continue;
+
+    auto const &SOCKET = SOCKETS[ALIAS.socket];
+    a_aliases[SOCKET.storage.key()] = SOCKET.handle;
+  }
+
+  for (auto const element : m_elements)
+    if (element->hash() == HASH) static_cast<Package const *>(element)->collectAliases(a_aliases);
+}
+
+void Package::invalidateSchedule()
+{
+  pauseDispatchThread();
+
+  restoreAliases();
+  m_scheduleDirty = true;
+
+  // A flattened parent schedules this package's elements itself.
+  if (m_package && m_flattenPackages) m_package->invalidateSchedule();
+
+  resumeDispatchThread();
+}
+
+std::shared_ptr<SnapshotBuffer> Package::subscribeSnapshots()
+{
+  if (m_package) return m_package->subscribeSnapshots();
+
+  auto buffer = std::make_shared<SnapshotBuffer>();
+
+  pauseDispatchThread();
+  m_snapshotBuffers.push_back(buffer);
+  resumeDispatchThread();
+
+  return buffer;
+}
+
+void Package::unsubscribeSnapshots(std::shared_ptr<SnapshotBuffer> const &a_buffer)
+{
+  if (m_package) {
+    m_package->unsubscribeSnapshots(a_buffer);
+    return;
+  }
+
+  pauseDispatchThread();
+  m_snapshotBuffers.erase(std::remove(std::begin(m_snapshotBuffers), std::end(m_snapshotBuffers), a_buffer),
+                          std::end(m_snapshotBuffers));
+  resumeDispatchThread();
+}
+
+void Package::publishSnapshots()
+{
+  if (m_snapshotBuffers.empty()) return;
+
+  // Readers pick snapshots up at display rate at best, copying for one still holding the previous is wasted work.
+  auto const CONSUMED = [](std::shared_ptr<SnapshotBuffer> const &a_buffer) { return a_buffer->consumed(); };
+  if (std::none_of(std::begin(m_snapshotBuffers), std::end(m_snapshotBuffers), CONSUMED)) return;
+
+  auto const &SIGNALS = signals();
+  uint64_t const TICK{ m_ticks };
+
+  // Readers resolve sockets through the aliases published with the signals, the live handles keep changing.
+  uint64_t const LAYOUT{ m_layout };
+  if (!m_publishedAliases || m_publishedLayout != LAYOUT) {
+    auto aliases = std::make_shared<SnapshotBuffer::Aliases>();
+    collectAliases(*aliases);
+    m_publishedAliases = std::move(aliases);
+    m_publishedLayout = LAYOUT;
+  }
+
+  for (auto const &buffer : m_snapshotBuffers) {
+    if (!buffer->consumed()) continue;
+
+    auto &snapshot = buffer->back();
+    snapshot.tick = TICK;
+    snapshot.layout = LAYOUT;
+    snapshot.aliases = m_publishedAliases;
+    buffer->publish(SIGNALS);
+  }
+}
+
+void Package::post(Edit a_edit)
+{
+  if (m_package) {
+    m_package->post(std::move(a_edit));
+    return;
+  }
+
+  m_edits->push(std::move(a_edit));
+}
+
+void Package::apply(Edit const &a_edit)
+{
+  if (m_package) {
+    m_package->apply(a_edit);
+    return;
+  }
+
+  // Only the thread holding the pause may edit in place, the dispatch thread stays parked until it resumes.
+  // Other producers wait in the queue, even while paused.
+  if (!m_dispatchThreadStarted || isDispatchThread() || isPauseOwner()) {
+    a_edit();
+    return;
+  }
+
+  std::promise<void> done{};
+  auto finished = done.get_future();
+  m_edits->push([&a_edit, &done] {
+    a_edit();
+    done.set_value();
+  });
+  finished.wait();
+}
+
+void Package::applyEdits()
+{
+  Edit edit{};
+  while (m_edits->pop(edit)) edit();
+}
+
+bool Package::isDispatchThread() const
+{
+  return std::this_thread::get_id() == m_dispatchThread.get_id();
+}
+
+bool Package::isPauseOwner() const
+{
+  return m_paused && std::this_thread::get_id() == m_pauseOwner.load();
+}
+
+Element *Package::add(string::hash_t const a_hash)
+{
+  Element *element{};
+  apply([this, a_hash, &element] {
+    spaghetti::log::debug("Adding element..");
+
+    spaghetti::Registry &registry{ spaghetti::Registry::get() };
+
+    element = registry.createElement(a_hash, *m_arena, signals());
+    assert(element);
+
+    insert(element);
+    invalidateSchedule();
+  });
+
+  return element;
+}
+
+void Package::insert(Element *const a_element)
+{
   size_t index{};
   if (m_free.empty()) {
-    index = m_elements.size();
-    m_elements.emplace_back(element);
+    index = m_slots.size();
+    m_slots.emplace_back();
   } else {
     index = m_free.back();
-    assert(m_elements[index] == nullptr);
-    m_elements[index] = element;
     m_free.pop_back();
   }
 
-  element->m_package = this;
-  element->m_id = index;
-  element->reset();
-
-  resumeDispatchThread();
+  auto &slot = m_slots[index];
+  assert(slot.element == nullptr);
+  slot.element = a_element;
+  slot.dense = static_cast<uint32_t>(m_elements.size());
+  m_elements.push_back(a_element);
+
+  a_element->m_package = this;
+  a_element->m_id = index;
+  a_element->bindSignals(signals());
+  a_element->reset();
+
+  if (a_element->hash() == HASH) {
+    auto const package = static_cast<Package *>(a_element);
+    package->m_evaluationMode = m_evaluationMode;
+    package->m_zeroCopyConnections = m_zeroCopyConnections;
+    package->m_flattenPackages = m_flattenPackages;
+  }
+}
 
-  return element;
+void Package::reserve(size_t const a_elements, size_t const a_connections)
+{
+  size_t const ELEMENTS{ m_elements.size() + a_elements };
+  m_slots.reserve(ELEMENTS + 1);
+  m_elements.reserve(ELEMENTS);
+
+  size_t const CONNECTIONS{ m_connections.size() + a_connections };
+  m_connections.reserve(CONNECTIONS);
+  m_connectionPositions.reserve(CONNECTIONS);
+  m_connectionsBySource.reserve(CONNECTIONS);
+  m_connectionsByTarget.reserve(CONNECTIONS);
 }
 
 void Package::remove(size_t const a_id)
 {
-  pauseDispatchThread();
+  apply([this, a_id] {
+    spaghetti::log::debug("Removing element {}..", a_id);
 
-  spaghetti::log::debug("Removing element {}..", a_id);
+    assert(a_id > 0);
+    assert(contains(a_id));
 
-  assert(a_id > 0);
-  assert(a_id < m_elements.size());
-  assert(std::find(std::begin(m_free), std::end(m_free), a_id) == std::end(m_free));
+    invalidateSchedule();
 
-  delete m_elements[a_id];
-  m_elements[a_id] = nullptr;
-  m_free.emplace_back(a_id);
+    auto &slot = m_slots[a_id];
 
-  resumeDispatchThread();
+    // Connections only name ids, left behind they would attach to whatever reuses the slot.
+    std::vector<size_t> connections{};
+    auto const collect = [a_id, &connections](ConnectionIndex const &a_lists, size_t const a_sockets) {
+      for (size_t socket = 0; socket < a_sockets; ++socket) {
+        auto const IT = a_lists.find(socketKey(a_id, static_cast<uint8_t>(socket)));
+        if (IT != a_lists.end()) connections.insert(std::end(connections), std::begin(IT->second), std::end(IT->second));
+      }
+    };
+    collect(m_connectionsBySource, slot.element->m_outputs.size());
+    collect(m_connectionsByTarget, slot.element->m_inputs.size());
+    unlink(connections);
+
+    // The last element moves into the gap, so m_elements stays free of holes.
+    auto const last = m_elements.back();
+    m_elements[slot.dense] = last;
+    if (last != slot.element) m_slots[last->m_id].dense = slot.dense;
+    m_elements.pop_back();
+
+    destroy(slot.element);
+
+    slot.element = nullptr;
+    slot.generation++;
+    m_free.emplace_back(a_id);
+  });
+}
+
+std::vector<Element *> Package::add(std::vector<string::hash_t> const &a_hashes)
+{
+  std::vector<Element *> elements{};
+  elements.reserve(a_hashes.size());
+
+  apply([this, &a_hashes, &elements] {
+    spaghetti::log::debug("Adding {} elements..", a_hashes.size());
+
+    spaghetti::Registry &registry{ spaghetti::Registry::get() };
+
+    reserve(a_hashes.size(), 0);
+    for (auto const HASH_TO_ADD : a_hashes) {
+      auto const element = registry.createElement(HASH_TO_ADD, *m_arena, signals());
+      assert(element);
+      insert(element);
+      elements.push_back(element);
+    }
+
+    invalidateSchedule();
+  });
+
+  return elements;
+}
+
+void Package::remove(std::vector<size_t> const &a_ids)
+{
+  apply([this, &a_ids] {
+    for (auto const ID : a_ids) remove(ID);
+  });
+}
+
+void Package::connect(Connections const &a_connections)
+{
+  apply([this, &a_connections] {
+    spaghetti::log::debug("Connecting {} sockets..", a_connections.size());
+
+    reserve(0, a_connections.size());
+    for (auto const &CONNECTION : a_connections) link(CONNECTION);
+
+    invalidateSchedule();
+  });
+}
+
+void Package::disconnect(Connections const &a_connections)
+{
+  apply([this, &a_connections] {
+    for (auto const &C : a_connections)
+      disconnect(C.from_id, C.from_socket, C.from_flags, C.to_id, C.to_socket, C.to_flags);
+  });
 }
 
 Element *Package::get(size_t const a_id) const
 {
-  assert(a_id < m_elements.size());
-  assert(std::find(std::begin(m_free), std::end(m_free), a_id) == std::end(m_free));
-  return m_elements[a_id];
+  assert(contains(a_id));
+  return m_slots[a_id].element;
 }
 
-bool Package::connect(size_t const a_sourceId, uint8_t const a_sourceSocket, uint8_t const a_sourceFlags, size_t const a_targetId,
-                      uint8_t const a_targetSocket, uint8_t const a_targetFlags)
+Package::Connections Package::connectionsFrom(size_t const a_id, uint8_t const a_socket) const
 {
-  pauseDispatchThread();
+  Connections connections{};
+  auto const IT = m_connectionsBySource.find(socketKey(a_id, a_socket));
+  if (IT == m_connectionsBySource.end()) return connections;
 
-  auto const source = get(a_sourceId);
-  auto const target = get(a_targetId);
-
-  spaghetti::log::info("Connecting source: {}@{}@{} to target: {}@{}@{}", a_sourceId, static_cast<int>(a_sourceSocket),static_cast<int>(a_sourceFlags),
-                        a_targetId, static_cast<int>(a_targetSocket),static_cast<int>(a_targetFlags));
-//a_sourceId != 0 ||
-  uint8_t  sourceFlags = a_sourceFlags;
- std::string str1 ("logic/package");
- /*if (str1.compare(source->type())==0) {
-     sourceFlags = ( a_sourceFlags == 2 )?1:2;
- }*/
-  bool isSourcePackage = (str1.compare(source->type())==0) && !source->isRoot();
-
-  //auto const &SOURCE =  sourceFlags == 2 && a_sourceId != 0 ? source->m_outputs : source->m_inputs;
-  //auto const &SOURCE = (isSourcePackage && a_sourceId != 0) || (sourceFlags != 2 && a_sourceId != 0) ? source->m_outputs : source->m_inputs;
-  auto const &SOURCE =  a_sourceId == 0  ?  source->m_inputs : source->m_outputs;
-  //a_targetId != 0 &&
-  uint8_t  targetFlags = a_targetFlags;
-  /*if (str1.compare(target->type())==0) {
-      targetFlags = ( a_targetFlags == 2 )?1:2;
-  }*/
-
-  //bool isTargetPackage = (str1.compare(target->type())==0) && !target->isRoot();
-
-  //auto &TARGET = (isTargetPackage && a_targetId != 0) || (targetFlags != 2 && a_targetId != 0) ? target->m_inputs : target->m_outputs;
-  auto &TARGET = a_targetId == 0 ? target->m_outputs : target->m_inputs ;
-  auto const SOURCE_SIZE = SOURCE.size();
-  auto const TARGET_SIZE = TARGET.size();
-  assert(a_sourceSocket < SOURCE_SIZE && "Socket ID don't exist");
-  assert(a_targetSocket < TARGET_SIZE && "Socket ID don't exist");
-
-  TARGET[a_targetSocket].id = a_sourceId;
-  TARGET[a_targetSocket].slot = a_sourceSocket;
-  TARGET[a_targetSocket].inFlags = sourceFlags;
-
-  spaghetti::log::info("Notifying {}({})@{} when {}({})@{} changes..", a_targetId, target->name(),
-                        static_cast<int32_t>(a_targetSocket), a_sourceId, source->name(),
-                        static_cast<int32_t>(a_sourceSocket));
-
-  m_connections.emplace_back(Connection{ a_sourceId, a_sourceSocket, a_sourceFlags, a_targetId, a_targetSocket, a_targetFlags });
-
-  auto &dependencies = m_dependencies[a_sourceId];
-  auto const IT = std::find(std::begin(dependencies), std::end(dependencies), a_targetId);
-  if (IT == std::end(dependencies)) dependencies.push_back(a_targetId);
+  for (auto const INDEX : IT->second) connections.push_back(m_connections[INDEX]);
+  return connections;
+}
 
-  resumeDispatchThread();
+Package::Connections Package::connectionsTo(size_t const a_id, uint8_t const a_socket) const
+{
+  Connections connections{};
+  auto const IT = m_connectionsByTarget.find(socketKey(a_id, a_socket));
+  if (IT == m_connectionsByTarget.end()) return connections;
 
-  return true;
+  for (auto const INDEX : IT->second) connections.push_back(m_connections[INDEX]);
+  return connections;
 }
 
-bool Package::disconnect(size_t const a_sourceId, uint8_t const a_outputId, uint8_t const a_outputFlags,size_t const a_targetId,
-                         uint8_t const a_inputId, uint8_t const a_inputFlags)
+void Package::addConnection(Connection const &a_connection)
 {
-  pauseDispatchThread();
+  size_t const INDEX{ m_connections.size() };
+  auto &bySource = m_connectionsBySource[socketKey(a_connection.from_id, a_connection.from_socket)];
+  auto &byTarget = m_connectionsByTarget[socketKey(a_connection.to_id, a_connection.to_socket)];
+
+  m_connections.push_back(a_connection);
+  m_connectionPositions.push_back(ConnectionPositions{ bySource.size(), byTarget.size() });
+  bySource.push_back(INDEX);
+  byTarget.push_back(INDEX);
+}
+
+void Package::unlinkSocket(size_t const a_id, uint8_t const a_socket, bool const a_input)
+{
+  apply([this, a_id, a_socket, a_input] {
+    // Seen from inside, the package's own inputs are sources and its outputs targets.
+    auto const &LISTS = a_input == (a_id == 0) ? m_connectionsBySource : m_connectionsByTarget;
+    auto const IT = LISTS.find(socketKey(a_id, a_socket));
+    if (IT == LISTS.end()) return;
+
+    std::vector<size_t> connections{ IT->second };
+    unlink(connections);
+    invalidateSchedule();
+  });
+}
+
+void Package::unlink(std::vector<size_t> &a_connections)
+{
+  // Highest first, removal only ever moves the last connection.
+  std::sort(std::begin(a_connections), std::end(a_connections), std::greater<size_t>());
+  a_connections.erase(std::unique(std::begin(a_connections), std::end(a_connections)), std::end(a_connections));
+
+  for (auto const INDEX : a_connections) {
+    auto const &CONNECTION = m_connections[INDEX];
+    auto const target = get(CONNECTION.to_id);
+    auto &sockets = CONNECTION.to_id == 0 ? target->m_outputs : target->m_inputs;
+    if (CONNECTION.to_socket < sockets.size()) {
+      auto &input = sockets[CONNECTION.to_socket];
+      input.id = 0;
+      input.slot = 0;
+      input.inFlags = 0;
+      resetIOSocketValue(input);
+    }
 
-  Element *const target{ get(a_targetId) };
+    removeConnection(INDEX);
+  }
+}
+
+void Package::removeConnection(size_t const a_index)
+{
+  auto const &REMOVED = m_connections[a_index];
+  auto const &POSITIONS = m_connectionPositions[a_index];
+
+  // Swap-and-pop everywhere: within both socket lists first, then in m_connections itself.
+  auto const unlink = [this](ConnectionIndex &a_lists, uint64_t const a_key, size_t const a_position, bool const a_source) {
+    auto const IT = a_lists.find(a_key);
+    auto &list = IT->second;
+    auto const LAST = list.back();
+    list[a_position] = LAST;
+    auto &positions = m_connectionPositions[LAST];
+    (a_source ? positions.bySource : positions.byTarget) = a_position;
+    list.pop_back();
+    if (list.empty()) a_lists.erase(IT);
+  };
+  unlink(m_connectionsBySource, socketKey(REMOVED.from_id, REMOVED.from_socket), POSITIONS.bySource, true);
+  unlink(m_connectionsByTarget, socketKey(REMOVED.to_id, REMOVED.to_socket), POSITIONS.byTarget, false);
+
+  size_t const LAST{ m_connections.size() - 1 };
+  if (a_index != LAST) {
+    auto const &MOVED = m_connections[LAST];
+    auto const &MOVED_POSITIONS = m_connectionPositions[LAST];
+    m_connectionsBySource[socketKey(MOVED.from_id, MOVED.from_socket)][MOVED_POSITIONS.bySource] = a_index;
+    m_connectionsByTarget[socketKey(MOVED.to_id, MOVED.to_socket)][MOVED_POSITIONS.byTarget] = a_index;
+    m_connections[a_index] = MOVED;
+    m_connectionPositions[a_index] = MOVED_POSITIONS;
+  }
+
+  m_connections.pop_back();
+  m_connectionPositions.pop_back();
+}
+
+void Package::indexConnections()
+{
+  auto const CONNECTIONS = std::move(m_connections);
+
+  m_connections.clear();
+  m_connectionPositions.clear();
+  m_connectionsBySource.clear();
+  m_connectionsByTarget.clear();
+
+  for (auto const &CONNECTION : CONNECTIONS) addConnection(CONNECTION);
+}
+
+Element *Package::get(Handle const a_handle) const
+{
+  if (a_handle.id >= m_slots.size()) return nullptr;
+
+  auto const &SLOT = m_slots[a_handle.id];
+  return SLOT.generation == a_handle.generation ? SLOT.element : nullptr;
+}
 
-  spaghetti::log::debug("Disconnecting source: {}@{} from target: {}@{}", a_sourceId, static_cast<int>(a_outputId),
-                        a_targetId, static_cast<int>(a_inputId));
+Package::Handle Package::handle(size_t const a_id) const
+{
+  assert(contains(a_id));
+  return Handle{ a_id, m_slots[a_id].generation };
+}
+
+void Package::compact()
+{
+  apply([this] {
+    if (m_free.empty()) return;
 
-  auto &targetInput = a_inputFlags != 2 ? target->m_inputs[a_inputId] : target->m_outputs[a_inputId];
-  targetInput.id = 0;
-  targetInput.slot = 0;
-  targetInput.inFlags = 0;
-  resetIOSocketValue(targetInput);
+    invalidateSchedule();
+
+    size_t const SIZE{ m_slots.size() };
+    size_t const COUNT{ m_elements.size() };
+
+    std::vector<size_t> ids(SIZE);
+    for (size_t i = 0; i < COUNT; ++i) ids[m_elements[i]->m_id] = i + 1;
+    auto const remap = [&ids, SIZE](size_t const a_id) { return a_id < SIZE ? ids[a_id] : 0; };
+
+    m_connections.erase(std::remove_if(std::begin(m_connections), std::end(m_connections),
+                                       [this](Connection const &a_connection) {
+                                         return !contains(a_connection.from_id) || !contains(a_connection.to_id);
+                                       }),
+                        std::end(m_connections));
+
+    for (auto &connection : m_connections) {
+      connection.from_id = remap(connection.from_id);
+      connection.to_id = remap(connection.to_id);
+    }
+    indexConnections();
+
+    auto const remapSockets = [&remap](IOSockets &a_sockets) {
+      for (auto &socket : a_sockets) socket.id = remap(socket.id);
+    };
+    // Only sockets fed from inside name our ids, the package's inputs belong to its parent and a nested package's
+    // outputs to that package.
+    remapSockets(m_outputs);
+
+    // A slot changing hands bumps its generation. Freed slots stay in the table, so nothing stale can match again.
+    std::vector<Slot> slots(SIZE);
+    slots[0] = m_slots[0];
+    for (size_t i = 0; i < COUNT; ++i) {
+      auto const element = m_elements[i];
+      size_t const ID{ i + 1 };
+      bool const MOVED{ element->m_id != ID };
 
-  auto it = std::remove_if(std::begin(m_connections), std::end(m_connections), [=](Connection &a_connection) {
-    return a_connection.from_id == a_sourceId && a_connection.from_socket == a_outputId && a_connection.from_flags == a_outputFlags
-    		&& a_connection.to_id == a_targetId && a_connection.to_socket == a_inputId && a_connection.to_flags == a_inputFlags;
+      remapSockets(element->m_inputs);
+
+      slots[ID] = Slot{ element, m_slots[ID].generation + (MOVED ? 1u : 0u), static_cast<uint32_t>(i) };
+      element->m_id = ID;
+    }
+
+    m_free.clear();
+    for (size_t id = SIZE - 1; id > COUNT; --id) {
+      slots[id] = Slot{ nullptr, m_slots[id].generation + 1, 0 };
+      m_free.push_back(id);
+    }
+
+    m_slots = std::move(slots);
   });
-  m_connections.erase(it, std::end(m_connections));
+}
 
-  auto &dependencies = m_dependencies[a_sourceId];
-  dependencies.erase(std::find(std::begin(dependencies), std::end(dependencies), a_targetId), std::end(dependencies));
+bool Package::connect(size_t const a_sourceId, uint8_t const a_sourceSocket, uint8_t const a_sourceFlags, size_t const a_targetId,
+                      uint8_t const a_targetSocket, uint8_t const a_targetFlags)
+{
+  apply([&] {
+    link(Connection{ a_sourceId, a_sourceSocket, a_sourceFlags, a_targetId, a_targetSocket, a_targetFlags });
+    invalidateSchedule();
+  });
 
-  resumeDispatchThread();
+  return true;
+}
+
+void Package::link(Connection const &a_connection)
+{
+  auto const source = get(a_connection.from_id);
+  auto const target = get(a_connection.to_id);
+
+  spaghetti::log::debug("Connecting source: {}@{}@{} to target: {}@{}@{}", a_connection.from_id,
+                        static_cast<int>(a_connection.from_socket), static_cast<int>(a_connection.from_flags),
+                        a_connection.to_id, static_cast<int>(a_connection.to_socket),
+                        static_cast<int>(a_connection.to_flags));
+
+  // The package's own inputs feed its children, its outputs are fed by them.
+  auto const &SOURCE = a_connection.from_id == 0 ? source->m_inputs : source->m_outputs;
+  auto &TARGET = a_connection.to_id == 0 ? target->m_outputs : target->m_inputs;
+  assert(a_connection.from_socket < SOURCE.size() && "Socket ID don't exist");
+  assert(a_connection.to_socket < TARGET.size() && "Socket ID don't exist");
+  (void)SOURCE;
+
+  auto &socket = TARGET[a_connection.to_socket];
+  socket.id = a_connection.from_id;
+  socket.slot = a_connection.from_socket;
+  socket.inFlags = a_connection.from_flags;
+
+  addConnection(a_connection);
+}
+
+bool Package::disconnect(size_t const a_sourceId, uint8_t const a_outputId, uint8_t const a_outputFlags,size_t const a_targetId,
+                         uint8_t const a_inputId, uint8_t const a_inputFlags)
+{
+  apply([&] {
+    Element *const target{ get(a_targetId) };
+
+    spaghetti::log::debug("Disconnecting source: {}@{} from target: {}@{}", a_sourceId, static_cast<int>(a_outputId),
+                          a_targetId, static_cast<int>(a_inputId));
+
+    auto &targetInput = a_inputFlags != 2 ? target->m_inputs[a_inputId] : target->m_outputs[a_inputId];
+    targetInput.id = 0;
+    targetInput.slot = 0;
+    targetInput.inFlags = 0;
+    resetIOSocketValue(targetInput);
+
+    std::vector<size_t> matching{};
+    auto const IT = m_connectionsByTarget.find(socketKey(a_targetId, a_inputId));
+    if (IT != m_connectionsByTarget.end()) {
+      for (auto const INDEX : IT->second) {
+        auto const &CONNECTION = m_connections[INDEX];
+        if (CONNECTION.from_id == a_sourceId && CONNECTION.from_socket == a_outputId &&
+            CONNECTION.from_flags == a_outputFlags && CONNECTION.to_flags == a_inputFlags)
+          matching.push_back(INDEX);
+      }
+    }
+
+    // Highest first, removal only ever moves the last connection.
+    std::sort(std::begin(matching), std::end(matching), std::greater<size_t>());
+    for (auto const INDEX : matching) removeConnection(INDEX);
+
+    invalidateSchedule();
+  });
 
   return true;
 }
 
 void Package::dispatchThreadFunction()
 {
-  using clock_t = std::chrono::high_resolution_clock;
+  using clock_t = std::chrono::steady_clock;
 
-  auto const ONE_MILLISECOND = std::chrono::milliseconds(1);
-
-  auto last = clock_t::now() - ONE_MILLISECOND;
+  auto last = clock_t::now() - m_tickInterval.load();
+  auto deadline = clock_t::now();
+  auto previousInterval = m_tickInterval.load();
 
   while (!m_quit) {
     auto const NOW = clock_t::now();
@@ -366,26 +1238,69 @@ void Package::dispatchThreadFunction()
     calculate();
 
     last = NOW;
+    m_ticks++;
+
+    publishSnapshots();
+
+    // Free running or a new interval starts counting from now, otherwise the counters report the switch as overruns.
+    auto const INTERVAL = m_tickInterval.load();
+    if (INTERVAL.count() == 0 || INTERVAL != previousInterval) deadline = clock_t::now();
+    previousInterval = INTERVAL;
+
+    if (INTERVAL.count() > 0) {
+      deadline += INTERVAL;
 
-    auto const WAIT_START = clock_t::now();
-    while ((clock_t::now() - WAIT_START) < ONE_MILLISECOND) std::this_thread::sleep_for(ONE_MILLISECOND);
+      auto const FINISHED = clock_t::now();
+      if (FINISHED >= deadline) {
+        // Skip the deadlines already missed instead of bursting through them to catch up.
+        auto const MISSED = static_cast<uint64_t>((FINISHED - deadline) / INTERVAL);
+        m_overruns++;
+        m_missedTicks += MISSED;
+        deadline += INTERVAL * static_cast<int64_t>(MISSED + 1);
+      }
+
+      sleepUntil(deadline);
+    }
 
     if (m_pause) {
       spaghetti::log::trace("Pause requested..");
+      std::unique_lock<std::mutex> lock{ m_pauseMutex };
       m_paused = true;
+      m_pauseCondition.notify_all();
       spaghetti::log::trace("Pausing..");
-      while (m_pause) std::this_thread::yield();
+      m_pauseCondition.wait(lock, [this] { return !m_pause; });
       m_paused = false;
+      deadline = clock_t::now();
       spaghetti::log::trace("Pause stopped..");
     }
   }
 }
 
+void Package::sleepUntil(std::chrono::steady_clock::time_point const &a_deadline)
+{
+#if defined(__linux__)
+  auto const SINCE_EPOCH = std::chrono::duration_cast<std::chrono::nanoseconds>(a_deadline.time_since_epoch());
+  timespec deadline{};
+  deadline.tv_sec = static_cast<time_t>(SINCE_EPOCH.count() / 1000000000);
+  deadline.tv_nsec = static_cast<long>(SINCE_EPOCH.count() % 1000000000);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) continue;
+#else
+  std::this_thread::sleep_until(a_deadline);
+#endif
+}
+
+void Package::setTickInterval(std::chrono::nanoseconds const a_interval)
+{
+  assert(a_interval.count() >= 0);
+  m_tickInterval = a_interval;
+}
+
 void Package::startDispatchThread()
 {
   if (m_dispatchThreadStarted) return;
 
   spaghetti::log::trace("Starting dispatch thread..");
+  m_quit = false;
   m_dispatchThread = std::thread(&Package::dispatchThreadFunction, this);
   m_dispatchThreadStarted = true;
 }
@@ -396,18 +1311,21 @@ void Package::quitDispatchThread()
 
   spaghetti::log::trace("Quitting dispatch thread..");
 
-  if (m_pause) {
-    spaghetti::log::trace("Dispatch thread paused, waiting..");
-    while (m_pause) std::this_thread::yield();
+  {
+    std::unique_lock<std::mutex> lock{ m_pauseMutex };
+    if (m_pause) spaghetti::log::trace("Dispatch thread paused, waiting..");
+    m_pauseCondition.wait(lock, [this] { return !m_pause; });
+    m_quit = true;
   }
 
-  m_quit = true;
   if (m_dispatchThread.joinable()) {
     spaghetti::log::trace("Waiting for dispatch thread join..");
     m_dispatchThread.join();
     spaghetti::log::trace("After dispatch thread join..");
   }
   m_dispatchThreadStarted = false;
+
+  applyEdits();
 }
 
 void Package::pauseDispatchThread()
@@ -417,18 +1335,27 @@ void Package::pauseDispatchThread()
     return;
   }
 
-  if (!m_dispatchThreadStarted) return;
+  // Edits applied between ticks already run on the dispatch thread, there is nothing to wait for.
+  if (!m_dispatchThreadStarted || isDispatchThread()) return;
 
-  m_pauseCount++;
+  auto const SELF = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lock{ m_pauseMutex };
 
-  spaghetti::log::trace("Trying to pause dispatch thread ({})..", m_pauseCount.load());
+  // The pause is exclusive, the owner may nest it, anyone else waits until it is fully resumed.
+  if (m_pauseOwner.load() == SELF) {
+    m_pauseCount++;
+    spaghetti::log::trace("Trying to pause dispatch thread ({})..", m_pauseCount.load());
+    return;
+  }
 
-  if (m_pauseCount > 1) return;
+  m_pauseCondition.wait(lock, [this] { return !m_pause; });
 
-  m_pause = true;
+  spaghetti::log::trace("Pausing dispatch thread..");
 
-  spaghetti::log::trace("Pausing dispatch thread ({})..", m_pauseCount.load());
-  while (!m_paused) std::this_thread::yield();
+  m_pauseOwner = SELF;
+  m_pauseCount = 1;
+  m_pause = true;
+  m_pauseCondition.wait(lock, [this] { return m_paused.load(); });
 }
 
 void Package::resumeDispatchThread()
@@ -438,67 +1365,161 @@ void Package::resumeDispatchThread()
     return;
   }
 
-  if (!m_dispatchThreadStarted) return;
+  if (!m_dispatchThreadStarted || isDispatchThread()) return;
 
-  m_pauseCount--;
+  {
+    std::lock_guard<std::mutex> lock{ m_pauseMutex };
+    assert(m_pauseOwner.load() == std::this_thread::get_id() && "Resuming a pause held by another thread");
+    if (m_pauseOwner.load() != std::this_thread::get_id()) return;
 
-  spaghetti::log::trace("Trying to resume dispatch thread ({})..", m_pauseCount.load());
+    m_pauseCount--;
 
-  if (m_pauseCount > 0) return;
+    spaghetti::log::trace("Trying to resume dispatch thread ({})..", m_pauseCount.load());
 
-  spaghetti::log::trace("Resuming dispatch thread ({})..", m_pauseCount.load());
+    if (m_pauseCount > 0) return;
 
-  m_pause = false;
+    spaghetti::log::trace("Resuming dispatch thread..");
+
+    m_pauseOwner = std::thread::id{};
+    m_pause = false;
+  }
+  m_pauseCondition.notify_all();
 }
 
-void Package::open(std::string const &a_filename)
+bool Package::open(std::string const &a_filename)
 {
   spaghetti::log::debug("Opening package {}", a_filename);
 
+  // External packages it refers to are looked up again, but only once however many instances there are.
+  Registry::get().beginPackageBatch();
+
+  if (BinaryPackage::isBinary(a_filename)) {
+    BinaryPackage const FILE{ a_filename };
+    if (!FILE.isValid()) return false;
+
+    bool restored{};
+    apply([this, &FILE, &a_filename, &restored] {
+      // Well formed properties can still hold values of the wrong type for their element.
+      try {
+        restore(FILE, 0);
+        restored = true;
+      } catch (Json::exception const &a_exception) {
+        spaghetti::log::error("Can't restore package {}: {}", a_filename, a_exception.what());
+      }
+
+      m_isExternal = m_package != nullptr;
+      spaghetti::log::debug("{} Is external: {}", a_filename, m_isExternal);
+    });
+    return restored;
+  }
+
   std::ifstream file{ a_filename };
-  if (!file.is_open()) return;
+  if (!file.is_open()) return false;
 
-  pauseDispatchThread();
+  // A nested package may turn out to be external, which is only known after its elements were read.
+  if (m_package != nullptr) {
+    Json json{};
+    file >> json;
 
-  Json json{};
-  file >> json;
+    apply([this, &json, &a_filename] {
+      deserialize(json);
 
-  deserialize(json);
+      m_isExternal = true;
+      spaghetti::log::debug("{} Is external: {}", a_filename, m_isExternal);
+    });
+    return true;
+  }
 
-  m_isExternal = m_package != nullptr;
-  spaghetti::log::debug("{} Is external: {}", a_filename, m_isExternal);
+  // One edit for the whole package instead of a handshake per element and connection. Top level elements
+  // are added as soon as each of them is parsed and dropped right after, so the tree never holds more than
+  // one of them. Connections are applied at the end, they need all ids remapped.
+  apply([this, &file, &a_filename] {
+    RemappedIds remappedIds{};
+    std::string keys[3]{};
 
-  resumeDispatchThread();
+    auto const JSON = Json::parse(file, [this, &keys, &remappedIds](int const a_depth, Json::parse_event_t const a_event,
+                                                                    Json &a_parsed) {
+      if (a_event == Json::parse_event_t::key && a_depth < 3) keys[a_depth] = a_parsed.get<std::string>();
+      if (a_event != Json::parse_event_t::object_end || a_depth != 3 || keys[1] != "package" || keys[2] != "elements")
+        return true;
+
+      loadElement(a_parsed, remappedIds);
+      return false;
+    });
+
+    deserializeHeader(JSON);
+    loadContent(JSON["package"], remappedIds);
+
+    m_isExternal = false;
+    spaghetti::log::debug("{} Is external: {}", a_filename, m_isExternal);
+  });
+
+  return true;
 }
 
 void Package::save(std::string const &a_filename)
 {
   spaghetti::log::debug("Saving package {}", a_filename);
 
-  pauseDispatchThread();
-
   Json json{};
-  serialize(json);
+  apply([this, &json] { serialize(json); });
+
+  if (isBinaryFilename(a_filename)) {
+    BinaryPackage::write(json, a_filename);
+    return;
+  }
 
   std::ofstream file{ a_filename };
   file << json.dump(2);
-
-  resumeDispatchThread();
 }
 
 Registry::PackageInfo Package::getInfoFor(std::string const &a_filename)
 {
   Registry::PackageInfo type{};
 
+  if (BinaryPackage::isBinary(a_filename)) {
+    BinaryPackage const FILE{ a_filename };
+    if (!FILE.isValid()) return type;
+
+    auto const &PACKAGE = FILE.package(FILE.element(0).package);
+    type.filename = a_filename;
+    type.icon = FILE.string(PACKAGE.icon);
+    type.path = FILE.string(PACKAGE.path);
+    return type;
+  }
+
   std::ifstream file{ a_filename };
   if (!file.is_open()) return type;
 
-  Json json{};
-  file >> json;
+  // Nothing is kept, every value is dropped as soon as it's parsed and parsing stops once package.icon and
+  // package.path are known. Objects and arrays can't be rejected up front, the parser loses track of the
+  // depth when they are.
+  struct HeaderRead {};
+  std::string keys[3]{};
+  bool hasIcon{}, hasPath{};
+
+  try {
+    Json::parse(file, [&](int const a_depth, Json::parse_event_t const a_event, Json &a_parsed) {
+      if (a_event == Json::parse_event_t::key && a_depth < 3) keys[a_depth] = a_parsed.get<std::string>();
+      if (a_event != Json::parse_event_t::value) return a_event != Json::parse_event_t::object_end &&
+                                                        a_event != Json::parse_event_t::array_end;
+
+      bool const IN_PACKAGE{ a_depth == 2 && keys[1] == "package" && a_parsed.is_string() };
+      if (IN_PACKAGE && keys[2] == "icon") {
+        type.icon = a_parsed.get<std::string>();
+        hasIcon = true;
+      } else if (IN_PACKAGE && keys[2] == "path") {
+        type.path = a_parsed.get<std::string>();
+        hasPath = true;
+      }
+
+      if (hasIcon && hasPath) throw HeaderRead{};
+      return false;
+    });
+  } catch (HeaderRead const &) {
+  }
 
   type.filename = a_filename;
-  type.icon = json["package"]["icon"];
-  type.path = json["package"]["path"];
 
   return type;
 }
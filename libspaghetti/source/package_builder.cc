@@ -0,0 +1,201 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spaghetti/package_builder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+#include "arena.h"
+#include <spaghetti/logger.h>
+
+namespace spaghetti {
+
+namespace {
+// Flags the editor gives sockets: the package's own outputs are fed like outputs, everything else like inputs.
+constexpr uint8_t const OUTPUT_FLAGS{ 2 };
+constexpr uint8_t const INPUT_FLAGS{ 1 };
+} // namespace
+
+PackageBuilder::PackageBuilder(Package &a_package)
+  : m_package{ a_package }
+{
+  m_entries.push_back(Entry{ 0, 0, &m_package });
+}
+
+void PackageBuilder::reserve(size_t const a_elements, size_t const a_links)
+{
+  m_entries.reserve(m_entries.size() + a_elements);
+  m_links.reserve(m_links.size() + a_links);
+}
+
+PackageBuilder::Ref PackageBuilder::add(string::hash_t const a_hash)
+{
+  m_entries.push_back(Entry{ a_hash, 0, nullptr });
+  m_added++;
+  return m_entries.size() - 1;
+}
+
+PackageBuilder::Ref PackageBuilder::add(std::vector<string::hash_t> const &a_hashes)
+{
+  Ref const FIRST{ m_entries.size() };
+  m_entries.reserve(m_entries.size() + a_hashes.size());
+  for (auto const HASH : a_hashes) m_entries.push_back(Entry{ HASH, 0, nullptr });
+  m_added += a_hashes.size();
+  return FIRST;
+}
+
+PackageBuilder::Ref PackageBuilder::use(size_t const a_id)
+{
+  if (a_id == 0) return PACKAGE;
+
+  m_entries.push_back(Entry{ 0, a_id, nullptr });
+  return m_entries.size() - 1;
+}
+
+void PackageBuilder::connect(Ref const a_source, uint8_t const a_sourceSocket, Ref const a_target,
+                             uint8_t const a_targetSocket)
+{
+  m_links.push_back(Link{ a_source, a_sourceSocket, a_target, a_targetSocket });
+}
+
+void PackageBuilder::connect(Links const &a_links)
+{
+  m_links.insert(std::end(m_links), std::begin(a_links), std::end(a_links));
+}
+
+Element *PackageBuilder::element(Ref const a_ref) const
+{
+  assert(a_ref < m_entries.size());
+  return m_entries[a_ref].element;
+}
+
+bool PackageBuilder::fail(std::string a_error)
+{
+  spaghetti::log::error("Can't build package: {}", a_error);
+  m_error = std::move(a_error);
+  return false;
+}
+
+bool PackageBuilder::commit()
+{
+  m_error.clear();
+
+  bool committed{};
+  m_package.apply([this, &committed] { committed = apply(); });
+  return committed;
+}
+
+bool PackageBuilder::apply()
+{
+  Registry &registry{ Registry::get() };
+  size_t const COUNT{ m_entries.size() };
+
+  for (size_t i = 1; i < COUNT; ++i) {
+    auto const &ENTRY = m_entries[i];
+    if (ENTRY.hash != 0 && !registry.hasElement(ENTRY.hash))
+      return fail("unknown element type for reference " + std::to_string(i));
+    if (ENTRY.hash == 0 && !m_package.contains(ENTRY.id))
+      return fail("no element " + std::to_string(ENTRY.id) + " for reference " + std::to_string(i));
+  }
+
+  // An input fed by more than one connection would take whichever value got copied last. Existing elements are
+  // keyed by id, they may be referred to more than once.
+  std::vector<std::pair<uint64_t, size_t>> targets{};
+  targets.reserve(m_links.size());
+  for (size_t i = 0; i < m_links.size(); ++i) {
+    auto const &LINK = m_links[i];
+    if (LINK.source >= COUNT || LINK.target >= COUNT)
+      return fail("link " + std::to_string(i) + " refers to an unknown element");
+
+    auto const &TARGET = m_entries[LINK.target];
+    if (TARGET.hash == 0 && !m_package.connectionsTo(TARGET.id, LINK.targetSocket).empty())
+      return fail("link " + std::to_string(i) + " targets an already connected socket");
+
+    uint64_t const ELEMENT{ TARGET.hash == 0 ? TARGET.id : (uint64_t{ 1 } << 55 | LINK.target) };
+    targets.emplace_back(ELEMENT << 8 | LINK.targetSocket, i);
+  }
+  std::sort(std::begin(targets), std::end(targets));
+  auto const sameSocket = [](auto const &a_lhs, auto const &a_rhs) { return a_lhs.first == a_rhs.first; };
+  auto const DUPLICATE = std::adjacent_find(std::begin(targets), std::end(targets), sameSocket);
+  if (DUPLICATE != std::end(targets))
+    return fail("link " + std::to_string(std::next(DUPLICATE)->second) + " targets the same socket as link " +
+                std::to_string(DUPLICATE->second));
+
+  // New elements get constructed before anything is checked against their sockets, they only exist in the
+  // arena until the whole batch turns out valid.
+  std::vector<Element *> created{};
+  created.reserve(m_added);
+  for (size_t i = 1; i < COUNT; ++i) {
+    auto &entry = m_entries[i];
+    if (entry.hash == 0) {
+      entry.element = m_package.get(entry.id);
+      continue;
+    }
+    entry.element = registry.createElement(entry.hash, *m_package.m_arena, m_package.signals());
+    assert(entry.element);
+    created.push_back(entry.element);
+  }
+
+  auto const discard = [this, &created] {
+    for (auto const element : created) m_package.destroy(element);
+    for (size_t i = 1; i < m_entries.size(); ++i) m_entries[i].element = nullptr;
+  };
+
+  for (size_t i = 0; i < m_links.size(); ++i) {
+    auto const &LINK = m_links[i];
+    auto const source = m_entries[LINK.source].element;
+    auto const target = m_entries[LINK.target].element;
+    auto const &SOURCE = LINK.source == PACKAGE ? source->inputs() : source->outputs();
+    auto const &TARGET = LINK.target == PACKAGE ? target->outputs() : target->inputs();
+    if (LINK.sourceSocket >= SOURCE.size() || LINK.targetSocket >= TARGET.size()) {
+      discard();
+      return fail("link " + std::to_string(i) + " refers to an unknown socket");
+    }
+  }
+
+  m_package.reserve(created.size(), m_links.size());
+  for (auto const element : created) m_package.insert(element);
+
+  for (size_t i = 1; i < COUNT; ++i) m_entries[i].id = m_entries[i].element->id();
+
+  for (auto const &LINK : m_links) {
+    uint8_t const TARGET_FLAGS{ LINK.target == PACKAGE ? OUTPUT_FLAGS : INPUT_FLAGS };
+    m_package.link(Package::Connection{ m_entries[LINK.source].id, LINK.sourceSocket, OUTPUT_FLAGS,
+                                        m_entries[LINK.target].id, LINK.targetSocket, TARGET_FLAGS });
+  }
+
+  m_package.invalidateSchedule();
+
+  spaghetti::log::debug("Built {} elements and {} connections", created.size(), m_links.size());
+
+  // Committed elements stay referable as existing ones, so the builder can carry on with another batch.
+  for (auto &entry : m_entries) entry.hash = 0;
+  m_links.clear();
+  m_added = 0;
+
+  return true;
+}
+
+} // namespace spaghetti
@@ -32,21 +32,22 @@
 // clang-format on
 
 #include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "arena.h"
 #include "filesystem.h"
 #include "shared_library.h"
+#include "worker_pool.h"
 
+#include <spaghetti/binary_package.h>
 #include <spaghetti/elements/all.h>
-#include "nodes/all.h"
 #include <spaghetti/logger.h>
 #include <spaghetti/version.h>
 
-inline void init_resources()
-{
-  Q_INIT_RESOURCE(icons);
-}
-
 static std::string get_application_path()
 {
 #ifndef MAX_PATH
@@ -66,12 +67,104 @@ static std::string get_application_path()
 
 namespace spaghetti {
 
+namespace {
+
+using Json = nlohmann::json;
+
+constexpr int const PACKAGES_INDEX_VERSION{ 1 };
+
+// What the last scan learned about a package file, reused as long as the file's size and mtime match.
+struct PackageIndexEntry {
+  uint64_t size{};
+  int64_t mtime{};
+  Registry::PackageInfo info{};
+};
+using PackagesIndex = std::unordered_map<std::string, PackageIndexEntry>;
+
+int64_t modificationTime(fs::path const &a_path)
+{
+#if SPAGHETTI_FS_IMPLEMENTATION == SPAGHETTI_FS_BOOST_FILESYSTEM
+  return static_cast<int64_t>(fs::last_write_time(a_path));
+#else
+  return static_cast<int64_t>(fs::last_write_time(a_path).time_since_epoch().count());
+#endif
+}
+
+PackagesIndex readPackagesIndex(fs::path const &a_path)
+{
+  PackagesIndex index{};
+
+  std::ifstream file{ a_path.string() };
+  if (!file.is_open()) return index;
+
+  try {
+    Json json{};
+    file >> json;
+    if (json["version"] != PACKAGES_INDEX_VERSION) return index;
+
+    for (auto const &PACKAGE : json["packages"]) {
+      PackageIndexEntry entry{};
+      entry.size = PACKAGE["size"].get<uint64_t>();
+      entry.mtime = PACKAGE["mtime"].get<int64_t>();
+      entry.info.filename = PACKAGE["filename"].get<std::string>();
+      entry.info.icon = PACKAGE["icon"].get<std::string>();
+      entry.info.path = PACKAGE["path"].get<std::string>();
+      index[entry.info.filename] = entry;
+    }
+  } catch (Json::exception const &a_exception) {
+    log::warn("Ignoring broken packages index {}: {}", a_path.string(), a_exception.what());
+    index.clear();
+  }
+
+  return index;
+}
+
+void writePackagesIndex(fs::path const &a_path, std::vector<std::string> const &a_filenames,
+                        std::vector<PackageIndexEntry> const &a_entries)
+{
+  auto jsonPackages = Json::array();
+  for (size_t i = 0; i < a_filenames.size(); ++i) {
+    auto const &ENTRY = a_entries[i];
+    // Broken packages stay out so they get reported again on the next scan.
+    if (ENTRY.info.filename.empty()) continue;
+    Json package{};
+    package["filename"] = a_filenames[i];
+    package["size"] = ENTRY.size;
+    package["mtime"] = ENTRY.mtime;
+    package["icon"] = ENTRY.info.icon;
+    package["path"] = ENTRY.info.path;
+    jsonPackages.push_back(package);
+  }
+
+  Json json{};
+  json["version"] = PACKAGES_INDEX_VERSION;
+  json["packages"] = jsonPackages;
+
+  std::ofstream file{ a_path.string() };
+  file << json.dump();
+}
+
+} // namespace
+
 struct Registry::PIMPL {
+  struct CachedDefinition {
+    uint64_t size{};
+    int64_t mtime{};
+    uint64_t batch{};
+    std::shared_ptr<PackageDefinition const> definition{};
+  };
+
   using Plugins = std::vector<std::shared_ptr<SharedLibrary>>;
   using MetaInfos = std::vector<MetaInfo>;
+  using MetaInfoIndices = std::unordered_map<string::hash_t, size_t>;
   MetaInfos metaInfos{};
+  MetaInfoIndices metaInfoIndices{};
   Plugins plugins{};
   Packages packages{};
+  std::unordered_map<std::string, std::string> packageFilenames{};
+  std::mutex definitionsMutex{};
+  std::unordered_map<std::string, CachedDefinition> definitions{};
+  uint64_t definitionsBatch{ 1 };
   fs::path app_path{};
   fs::path system_plugins_path{};
   fs::path user_plugins_path{};
@@ -135,11 +228,9 @@ Registry::Registry()
 
 void Registry::registerInternalElements()
 {
-  init_resources();
-
   using namespace elements;
 
-  registerElement<Package, nodes::Package>("Package", ":/logic/package.png");
+  registerElement<Package>("Package", ":/logic/package.png");
 
   registerElement<gates::And>("AND (Bool)", ":/gates/and.png");
   registerElement<gates::Nand>("NAND (Bool)", ":/gates/nand.png");
@@ -169,7 +260,7 @@ void Registry::registerInternalElements()
   registerElement<logic::MultiplexerInt>("Multiplexer (Int)", ":/unknown.png");
   registerElement<logic::DemultiplexerInt>("Demultiplexer (Int)", ":/unknown.png");
 
-  registerElement<logic::Blinker, nodes::logic::Blinker>("Blinker (Bool)", ":/unknown.png");
+  registerElement<logic::Blinker>("Blinker (Bool)", ":/unknown.png");
   registerElement<logic::Switch>("Switch (Int)", ":/logic/switch.png");
 
   registerElement<logic::TriggerFalling>("Trigger Falling (Bool)", ":/unknown.png");
@@ -199,35 +290,33 @@ void Registry::registerInternalElements()
   registerElement<math::Lerp>("Lerp (Float)", ":/unknown.png");
   registerElement<math::Sign>("Sign (Float)", ":/unknown.png");
 
-  registerElement<pneumatic::Tank, nodes::pneumatic::Tank>("Tank", ":/unknown.png");
+  registerElement<pneumatic::Tank>("Tank", ":/unknown.png");
   registerElement<pneumatic::Valve>("Valve", ":/unknown.png");
 
   registerElement<timers::DeltaTime>("Delta Time (ms)", ":/logic/clock.png");
-  registerElement<timers::Clock, nodes::timers::Clock>("Clock (ms)", ":/logic/clock.png");
+  registerElement<timers::Clock>("Clock (ms)", ":/logic/clock.png");
   registerElement<timers::TimerOn>("T_ON", ":/logic/clock.png");
   registerElement<timers::TimerOff>("T_OFF", ":/logic/clock.png");
   registerElement<timers::TimerPulse>("T_PULSE", ":/logic/clock.png");
 
   registerElement<ui::BCDToSevenSegmentDisplay>("BCD -> 7SD", ":/unknown.png");
 
-  registerElement<ui::FloatInfo, nodes::ui::FloatInfo>("Info (Float)", ":/values/const_float.png");
-  registerElement<ui::IntInfo, nodes::ui::IntInfo>("Info (Int)", ":/values/const_int.png");
+  registerElement<ui::FloatInfo>("Info (Float)", ":/values/const_float.png");
+  registerElement<ui::IntInfo>("Info (Int)", ":/values/const_int.png");
 
-  registerElement<ui::PushButton, nodes::ui::PushButton>("Push Button (Bool)", ":/ui/push_button.png");
-  registerElement<ui::ToggleButton, nodes::ui::ToggleButton>("Toggle Button (Bool)", ":/ui/toggle_button.png");
+  registerElement<ui::PushButton>("Push Button (Bool)", ":/ui/push_button.png");
+  registerElement<ui::ToggleButton>("Toggle Button (Bool)", ":/ui/toggle_button.png");
 
-  registerElement<ui::SevenSegmentDisplay, nodes::ui::SevenSegmentDisplay>("7 Segment Display", ":/unknown.png");
+  registerElement<ui::SevenSegmentDisplay>("7 Segment Display", ":/unknown.png");
 
-  registerElement<values::ConstBool, nodes::values::ConstBool>("Const value (Bool)", ":/values/const_bool.png");
-  registerElement<values::ConstFloat, nodes::values::ConstFloat>("Const value (Float)", ":/values/const_float.png");
-  registerElement<values::ConstInt, nodes::values::ConstInt>("Const value (Int)", ":/values/const_int.png");
+  registerElement<values::ConstBool>("Const value (Bool)", ":/values/const_bool.png");
+  registerElement<values::ConstFloat>("Const value (Float)", ":/values/const_float.png");
+  registerElement<values::ConstInt>("Const value (Int)", ":/values/const_int.png");
   registerElement<values::RandomBool>("Random value (Bool)", ":/values/random_value.png");
-  registerElement<values::RandomFloat, nodes::values::RandomFloat>("Random value (Float)", ":/values/random_value.png");
-  registerElement<values::RandomFloatIf, nodes::values::RandomFloatIf>("Random value If (Float)",
-                                                                       ":/values/random_value.png");
-  registerElement<values::RandomInt, nodes::values::RandomInt>("Random value (Int)", ":/values/random_value.png");
-  registerElement<values::RandomIntIf, nodes::values::RandomIntIf>("Random value If (Int)",
-                                                                   ":/values/random_value.png");
+  registerElement<values::RandomFloat>("Random value (Float)", ":/values/random_value.png");
+  registerElement<values::RandomFloatIf>("Random value If (Float)", ":/values/random_value.png");
+  registerElement<values::RandomInt>("Random value (Int)", ":/values/random_value.png");
+  registerElement<values::RandomIntIf>("Random value If (Int)", ":/values/random_value.png");
 
   registerElement<values::Degree2Radian>("Convert angle (Deg2Rad)", ":/unknown.png");
   registerElement<values::Radian2Degree>("Convert angle (Rad2Deg)", ":/unknown.png");
@@ -242,13 +331,7 @@ void Registry::registerInternalElements()
   registerElement<values::ClampFloat>("Clamp value (Float)", ":/unknown.png");
   registerElement<values::ClampInt>("Clamp value (Int)", ":/unknown.png");
 
-  // clang-format off
-  registerElement<values::CharacteristicCurve
-#ifdef SPAGHETTI_USE_CHARTS
-                  , nodes::values::CharacteristicCurve
-#endif
-                  >("Characteristic Curve", ":/unknown.png");
-  // clang-format on
+  registerElement<values::CharacteristicCurve>("Characteristic Curve", ":/unknown.png");
 }
 
 void Registry::loadPlugins()
@@ -296,22 +379,23 @@ std::vector<fs::path> scan_for_dirs(fs::path const &a_path)
 
 void Registry::loadPackages()
 {
-  Packages packages{};
+  std::vector<std::string> filenames{};
 
-  auto loadFrom = [&packages](fs::path const &a_path) {
+  auto loadFrom = [&filenames](fs::path const &a_path) {
     log::warn("Loading packages from {}", a_path.string());
+    if (!fs::is_directory(a_path)) return;
     auto directories = scan_for_dirs(a_path);
     directories.push_back(a_path);
     std::sort(std::begin(directories), std::end(directories));
     for (auto const &DIRECTORY : directories) {
       for (auto const &ENTRY : fs::directory_iterator(DIRECTORY)) {
-        if (fs::is_directory(ENTRY)) continue;
+        // Also skips dangling symlinks, which have no size or modification time to index.
+        if (!fs::is_regular_file(ENTRY.path())) continue;
         //std::string cext = ENTRY.path().extension();
         const std::string PACKAGE_EXT{".package"};
-        if (!(PACKAGE_EXT == ENTRY.path().extension())) continue;
-        auto const FILENAME = ENTRY.path().string();
-        log::warn("Loading package '{}'", FILENAME);
-        packages[FILENAME] = Package::getInfoFor(FILENAME);
+        auto const EXTENSION = ENTRY.path().extension();
+        if (!(PACKAGE_EXT == EXTENSION || BinaryPackage::EXTENSION == EXTENSION)) continue;
+        filenames.push_back(ENTRY.path().string());
       }
     }
   };
@@ -319,10 +403,61 @@ void Registry::loadPackages()
   loadFrom(m_pimpl->system_packages_path);
   loadFrom(m_pimpl->user_packages_path);
 
-  log::warn("Loaded {} packages", packages.size());
+  std::sort(std::begin(filenames), std::end(filenames));
+  filenames.erase(std::unique(std::begin(filenames), std::end(filenames)), std::end(filenames));
+
+  // Only packages that changed since the last scan get parsed, and those in parallel.
+  fs::path const INDEX_PATH{ m_pimpl->user_packages_path.parent_path() / "packages.index" };
+  auto const INDEX = readPackagesIndex(INDEX_PATH);
+
+  std::vector<PackageIndexEntry> entries(filenames.size());
+  std::vector<size_t> stale{};
+  for (size_t i = 0; i < filenames.size(); ++i) {
+    auto &entry = entries[i];
+    try {
+      entry.size = static_cast<uint64_t>(fs::file_size(filenames[i]));
+      entry.mtime = modificationTime(filenames[i]);
+    } catch (std::exception const &a_exception) {
+      // Removed while scanning, leaving its info empty keeps it out of both the index and the registry.
+      log::error("Can't read package '{}': {}", filenames[i], a_exception.what());
+      continue;
+    }
+
+    auto const IT = INDEX.find(filenames[i]);
+    if (IT != std::end(INDEX) && IT->second.size == entry.size && IT->second.mtime == entry.mtime)
+      entry.info = IT->second.info;
+    else
+      stale.push_back(i);
+  }
+
+  if (!stale.empty()) {
+    WorkerPool workers{ std::min<size_t>(stale.size(), std::max(1u, std::thread::hardware_concurrency())) };
+    workers.run(stale.size(), [&filenames, &entries, &stale](size_t const a_index) {
+      auto const &FILENAME = filenames[stale[a_index]];
+      log::warn("Loading package '{}'", FILENAME);
+      try {
+        entries[stale[a_index]].info = Package::getInfoFor(FILENAME);
+      } catch (std::exception const &a_exception) {
+        log::error("Can't read package '{}': {}", FILENAME, a_exception.what());
+      }
+    });
+  }
+
+  if (!stale.empty() || INDEX.size() != filenames.size()) writePackagesIndex(INDEX_PATH, filenames, entries);
+
+  Packages packages{};
+  for (size_t i = 0; i < filenames.size(); ++i)
+    if (!entries[i].info.filename.empty()) packages[filenames[i]] = entries[i].info;
+
+  log::warn("Loaded {} packages, {} of them from the index", packages.size(), filenames.size() - stale.size());
   for (auto const &PACKAGE : packages) log::warn("{} as '{}'", PACKAGE.first, PACKAGE.second.path);
 
+  std::unordered_map<std::string, std::string> packageFilenames{};
+  for (auto const &PACKAGE : packages)
+    if (!PACKAGE.second.path.empty()) packageFilenames.emplace(PACKAGE.second.path, PACKAGE.first);
+
   m_pimpl->packages = packages;
+  m_pimpl->packageFilenames = packageFilenames;
 }
 
 Element *Registry::createElement(string::hash_t const a_hash)
@@ -332,11 +467,12 @@ Element *Registry::createElement(string::hash_t const a_hash)
   return META_INFO.cloneElement();
 }
 
-Node *Registry::createNode(string::hash_t const a_hash)
+Element *Registry::createElement(string::hash_t const a_hash, Arena &a_arena, SignalStore &a_signals)
 {
   auto const &META_INFO = metaInfoFor(a_hash);
-  assert(META_INFO.cloneNode);
-  return META_INFO.cloneNode();
+  assert(META_INFO.constructElement);
+  Element::SignalScope const SCOPE{ a_signals };
+  return META_INFO.constructElement(a_arena.allocate(META_INFO.size));
 }
 
 std::string Registry::elementName(string::hash_t const a_hash)
@@ -354,15 +490,26 @@ std::string Registry::elementIcon(string::hash_t const a_hash)
 void Registry::addElement(MetaInfo &a_metaInfo)
 {
   auto &metaInfos = m_pimpl->metaInfos;
+  auto &metaInfoIndices = m_pimpl->metaInfoIndices;
+
+  auto const [IT, INSERTED] = metaInfoIndices.emplace(a_metaInfo.hash, metaInfos.size());
+  if (!INSERTED) {
+    // 32-bit FNV-1a can collide, refuse the second type instead of silently shadowing the first one.
+    auto const &EXISTING = metaInfos[IT->second];
+    // Registering the very same type twice is a programming error, not a collision.
+    assert(EXISTING.type != a_metaInfo.type);
+    log::error("Element type '{}' has the same hash ({}) as already registered '{}', skipping it", a_metaInfo.type,
+               a_metaInfo.hash, EXISTING.type);
+    return;
+  }
+
   metaInfos.push_back(std::move(a_metaInfo));
 }
 
 bool Registry::hasElement(string::hash_t const a_hash) const
 {
-  auto const &META_INFOS = m_pimpl->metaInfos;
-  auto const IT = std::find_if(std::begin(META_INFOS), std::end(META_INFOS),
-                               [a_hash](auto const &a_metaInfo) { return a_metaInfo.hash == a_hash; });
-  return IT != std::end(META_INFOS);
+  auto const &META_INFO_INDICES = m_pimpl->metaInfoIndices;
+  return META_INFO_INDICES.find(a_hash) != std::end(META_INFO_INDICES);
 }
 
 size_t Registry::size() const
@@ -373,11 +520,10 @@ size_t Registry::size() const
 
 Registry::MetaInfo const &Registry::metaInfoFor(string::hash_t const a_hash) const
 {
-  auto &metaInfos = m_pimpl->metaInfos;
-  assert(hasElement(a_hash));
-  auto const IT = std::find_if(std::begin(metaInfos), std::end(metaInfos),
-                               [a_hash](auto const &a_metaInfo) { return a_metaInfo.hash == a_hash; });
-  return *IT;
+  auto const &META_INFO_INDICES = m_pimpl->metaInfoIndices;
+  auto const IT = META_INFO_INDICES.find(a_hash);
+  assert(IT != std::end(META_INFO_INDICES));
+  return m_pimpl->metaInfos[IT->second];
 }
 
 Registry::MetaInfo const &Registry::metaInfoAt(size_t const a_index) const
@@ -391,6 +537,63 @@ Registry::Packages const &Registry::packages() const
   return m_pimpl->packages;
 }
 
+std::shared_ptr<Registry::PackageDefinition const> Registry::packageDefinition(std::string const &a_path)
+{
+  auto const IT = m_pimpl->packageFilenames.find(a_path);
+  std::string const FILENAME{ IT != std::end(m_pimpl->packageFilenames) ? IT->second : a_path };
+
+  // Held while compiling too, instances of one package opened together wait for a single compile.
+  std::lock_guard<std::mutex> lock{ m_pimpl->definitionsMutex };
+
+  auto &cached = m_pimpl->definitions[FILENAME];
+  uint64_t const BATCH{ m_pimpl->definitionsBatch };
+  if (cached.definition && cached.batch == BATCH) return cached.definition;
+
+  uint64_t size{};
+  int64_t mtime{};
+  try {
+    size = static_cast<uint64_t>(fs::file_size(FILENAME));
+    mtime = modificationTime(FILENAME);
+  } catch (std::exception const &a_exception) {
+    log::error("Can't read package '{}': {}", FILENAME, a_exception.what());
+    return {};
+  }
+
+  if (cached.definition && cached.size == size && cached.mtime == mtime) {
+    cached.batch = BATCH;
+    return cached.definition;
+  }
+
+  log::debug("Compiling package definition '{}'", FILENAME);
+
+  auto definition = std::make_shared<PackageDefinition>();
+  definition->filename = FILENAME;
+
+  if (BinaryPackage::isBinary(FILENAME))
+    definition->binary = std::make_shared<BinaryPackage const>(FILENAME);
+  else {
+    std::ifstream file{ FILENAME };
+    if (!file.is_open()) return {};
+    auto const JSON = Json::parse(file, nullptr, false);
+    if (JSON.is_discarded()) return {};
+    definition->binary = std::make_shared<BinaryPackage const>(JSON, FILENAME);
+  }
+  if (!definition->binary->isValid()) return {};
+
+  cached.size = size;
+  cached.mtime = mtime;
+  cached.batch = BATCH;
+  cached.definition = definition;
+
+  return definition;
+}
+
+void Registry::beginPackageBatch()
+{
+  std::lock_guard<std::mutex> lock{ m_pimpl->definitionsMutex };
+  m_pimpl->definitionsBatch++;
+}
+
 std::string Registry::appPath() const
 {
   return m_pimpl->app_path.string();
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spaghetti/signal_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace spaghetti {
+
+template<typename T>
+uint32_t SignalStore::allocate(Column<T> &a_column, std::vector<uint32_t> &a_free)
+{
+  if (a_free.empty()) {
+    assert(a_column.size() < INVALID_INDEX);
+    a_column.emplace_back();
+    return static_cast<uint32_t>(a_column.size() - 1);
+  }
+
+  uint32_t const INDEX{ a_free.back() };
+  a_free.pop_back();
+  a_column[INDEX] = T{};
+  return INDEX;
+}
+
+SignalStore::Handle SignalStore::allocate(ValueType const a_type)
+{
+  auto &free = m_free[static_cast<size_t>(a_type)];
+
+  switch (a_type) {
+    case ValueType::eBool: return Handle{ a_type, allocate(m_bools, free) };
+    case ValueType::eInt: return Handle{ a_type, allocate(m_ints, free) };
+    case ValueType::eFloat: return Handle{ a_type, allocate(m_floats, free) };
+    case ValueType::eByte: return Handle{ a_type, allocate(m_bytes, free) };
+    case ValueType::eWord64: return Handle{ a_type, allocate(m_words64, free) };
+  }
+
+  assert(false && "Wrong signal type");
+  return Handle{};
+}
+
+void SignalStore::release(Handle const a_handle)
+{
+  if (!a_handle.isValid()) return;
+
+  m_free[static_cast<size_t>(a_handle.type)].push_back(a_handle.index);
+}
+
+void SignalStore::reset(Handle const a_handle)
+{
+  switch (a_handle.type) {
+    case ValueType::eBool: m_bools[a_handle.index] = 0; break;
+    case ValueType::eInt: m_ints[a_handle.index] = 0; break;
+    case ValueType::eFloat: m_floats[a_handle.index] = 0.0f; break;
+    case ValueType::eByte: m_bytes[a_handle.index] = 0; break;
+    case ValueType::eWord64: m_words64[a_handle.index] = 0; break;
+  }
+}
+
+void SignalStore::copy(Handle const a_from, Handle const a_to)
+{
+  if (a_from.type == a_to.type) {
+    switch (a_to.type) {
+      case ValueType::eBool: m_bools[a_to.index] = m_bools[a_from.index]; break;
+      case ValueType::eInt: m_ints[a_to.index] = m_ints[a_from.index]; break;
+      case ValueType::eFloat: m_floats[a_to.index] = m_floats[a_from.index]; break;
+      case ValueType::eByte: m_bytes[a_to.index] = m_bytes[a_from.index]; break;
+      case ValueType::eWord64: m_words64[a_to.index] = m_words64[a_from.index]; break;
+    }
+    return;
+  }
+
+  switch (a_from.type) {
+    case ValueType::eBool: set(a_to, m_bools[a_from.index] != 0); break;
+    case ValueType::eInt: set(a_to, m_ints[a_from.index]); break;
+    case ValueType::eFloat: set(a_to, m_floats[a_from.index]); break;
+    case ValueType::eByte: set(a_to, m_bytes[a_from.index]); break;
+    case ValueType::eWord64: set(a_to, m_words64[a_from.index]); break;
+  }
+}
+
+bool SignalStore::contains(Handle const a_handle) const
+{
+  if (!a_handle.isValid()) return false;
+
+  switch (a_handle.type) {
+    case ValueType::eBool: return a_handle.index < m_bools.size();
+    case ValueType::eInt: return a_handle.index < m_ints.size();
+    case ValueType::eFloat: return a_handle.index < m_floats.size();
+    case ValueType::eByte: return a_handle.index < m_bytes.size();
+    case ValueType::eWord64: return a_handle.index < m_words64.size();
+  }
+
+  return false;
+}
+
+void SignalStore::snapshotTo(SignalStore &a_target) const
+{
+  // Plain assignment keeps the target's capacity, so steady-state snapshots don't allocate.
+  a_target.m_bools = m_bools;
+  a_target.m_ints = m_ints;
+  a_target.m_floats = m_floats;
+  a_target.m_bytes = m_bytes;
+  a_target.m_words64 = m_words64;
+}
+
+void SignalStore::snapshotTo(SignalStore &a_target, ValueType const a_type) const
+{
+  switch (a_type) {
+    case ValueType::eBool: a_target.m_bools = m_bools; break;
+    case ValueType::eInt: a_target.m_ints = m_ints; break;
+    case ValueType::eFloat: a_target.m_floats = m_floats; break;
+    case ValueType::eByte: a_target.m_bytes = m_bytes; break;
+    case ValueType::eWord64: a_target.m_words64 = m_words64; break;
+  }
+}
+
+template<typename T>
+void SignalStore::collectChanges(Column<T> const &a_column, Column<T> &a_seen, ValueType const a_type,
+                                 Changes &a_changes)
+{
+  size_t const SIZE{ a_column.size() };
+  size_t const SEEN{ std::min(SIZE, a_seen.size()) };
+  a_seen.resize(SIZE);
+
+  // Bitwise, so a NaN that stays NaN doesn't count as a change every time.
+  for (size_t i = 0; i < SIZE; ++i) {
+    if (i < SEEN && std::memcmp(&a_column[i], &a_seen[i], sizeof(T)) == 0) continue;
+    a_seen[i] = a_column[i];
+    a_changes.push_back(Handle{ a_type, static_cast<uint32_t>(i) });
+  }
+}
+
+void SignalStore::collectChanges(SignalStore &a_seen, Changes &a_changes) const
+{
+  collectChanges(m_bools, a_seen.m_bools, ValueType::eBool, a_changes);
+  collectChanges(m_ints, a_seen.m_ints, ValueType::eInt, a_changes);
+  collectChanges(m_floats, a_seen.m_floats, ValueType::eFloat, a_changes);
+  collectChanges(m_bytes, a_seen.m_bytes, ValueType::eByte, a_changes);
+  collectChanges(m_words64, a_seen.m_words64, ValueType::eWord64, a_changes);
+}
+
+size_t SignalStore::size() const
+{
+  size_t free{};
+  for (auto const &FREE : m_free) free += FREE.size();
+  return m_bools.size() + m_ints.size() + m_floats.size() + m_bytes.size() + m_words64.size() - free;
+}
+
+} // namespace spaghetti
@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "spaghetti/snapshot_buffer.h"
+
+#include <iterator>
+
+namespace spaghetti {
+
+void SnapshotBuffer::publish(SignalStore const &a_signals)
+{
+  m_changes.clear();
+  a_signals.collectChanges(m_seen, m_changes);
+
+  // Buffers rotate, so each one remembers which version of a column it holds and only stale columns get copied.
+  m_publishes++;
+  for (auto const HANDLE : m_changes) m_columns[static_cast<size_t>(HANDLE.type)] = m_publishes;
+
+  auto &snapshot = m_buffers[m_back];
+  for (size_t type = 0; type < std::size(m_columns); ++type) {
+    if (snapshot.columns[type] == m_columns[type]) continue;
+    a_signals.snapshotTo(snapshot.signals, static_cast<ValueType>(type));
+    snapshot.columns[type] = m_columns[type];
+  }
+
+  // The reader skips snapshots it was too slow for, so changes pile up until it picks one up. Once it has,
+  // only the news are left; racing with it just means handing out a few changes twice.
+  if (consumed()) {
+    for (auto const HANDLE : m_pending) m_marked[static_cast<size_t>(HANDLE.type)][HANDLE.index] = 0;
+    m_pending.clear();
+  }
+
+  mark(m_changes);
+  snapshot.changes = m_pending;
+
+  auto const PREVIOUS = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+  m_back = PREVIOUS & INDEX_MASK;
+}
+
+void SnapshotBuffer::mark(SignalStore::Changes const &a_changes)
+{
+  for (auto const HANDLE : a_changes) {
+    auto &marked = m_marked[static_cast<size_t>(HANDLE.type)];
+    if (HANDLE.index >= marked.size()) marked.resize(HANDLE.index + 1);
+    if (marked[HANDLE.index]) continue;
+    marked[HANDLE.index] = 1;
+    m_pending.push_back(HANDLE);
+  }
+}
+
+bool SnapshotBuffer::acquire()
+{
+  if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+
+  auto const PREVIOUS = m_middle.exchange(m_front, std::memory_order_acq_rel);
+  m_front = PREVIOUS & INDEX_MASK;
+  return true;
+}
+
+} // namespace spaghetti
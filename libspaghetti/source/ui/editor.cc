@@ -55,6 +55,7 @@
 #include <vector>
 
 #include <spaghetti/elements/logic/all.h>
+#include "spaghetti/binary_package.h"
 #include "spaghetti/node.h"
 #include "spaghetti/package.h"
 #include "spaghetti/registry.h"
@@ -394,7 +395,8 @@ void Editor::openPackage()
   foreach (PackageView *temp, this->findChildren<PackageView *>())
     temp->setUpdatesEnabled(false);
 
-  QString const FILENAME{ QFileDialog::getOpenFileName(this, "Open .package", PACKAGES_DIR, "*.package") };
+  QString const FILENAME{ QFileDialog::getOpenFileName(this, "Open .package", PACKAGES_DIR,
+                                                          "Packages (*.package *.bpackage)") };
 
   foreach (PackageView *temp, this->findChildren<PackageView *>())
     temp->setUpdatesEnabled(true);
@@ -458,13 +460,15 @@ void Editor::savePackageView(bool const a_saveAs)
     foreach (PackageView *temp, this->findChildren<PackageView *>())
       temp->setUpdatesEnabled(false);
 
-    QString filename{ QFileDialog::getSaveFileName(this, "Save .package", PACKAGES_DIR, "*.package") };
+    QString filename{ QFileDialog::getSaveFileName(this, "Save .package", PACKAGES_DIR,
+                                                       "Package (*.package);;Binary package (*.bpackage)") };
 
     foreach (PackageView *temp, this->findChildren<PackageView *>())
       temp->setUpdatesEnabled(true);
 
     if (filename.isEmpty()) return;
-    if (!filename.endsWith(".package")) filename += ".package";
+    if (!filename.endsWith(".package") && !filename.endsWith(BinaryPackage::EXTENSION))
+      filename += ".package";
 
     packageView->setFilename(filename);
     QDir const packagesDir{ PACKAGES_DIR };
@@ -24,16 +24,33 @@
 
 #include <cmath>
 
+#include <QElapsedTimer>
 #include <QStyleOptionGraphicsItem>
 
 #include "colors.h"
 #include "spaghetti/socket_item.h"
 #include "spaghetti/node.h"
+#include "ui/link_layer.h"
 //#include "spaghetti/element.h"
 #include "spaghetti/logger.h"
 
 namespace spaghetti {
 
+namespace {
+// Dashes move by time rather than by frame, so their speed doesn't depend on the refresh rate.
+qreal const DASH_SPEED{ 0.1 };
+
+qreal dashOffset()
+{
+  static QElapsedTimer const CLOCK{ [] {
+    QElapsedTimer clock{};
+    clock.start();
+    return clock;
+  }() };
+  return -DASH_SPEED * static_cast<qreal>(CLOCK.elapsed());
+}
+} // namespace
+
 LinkItem::LinkItem(QGraphicsItem *a_parent)
   : QGraphicsPathItem{ a_parent }
 {
@@ -57,26 +74,14 @@ void LinkItem::paint(QPainter *a_painter, QStyleOptionGraphicsItem const *a_opti
   (void)a_option;
   (void)a_widget;
 
-  QColor const signalColor{ (m_isSignalOn ? m_colorSignalOn : m_colorSignalOff) };
-  QColor const notActive{ (isSelected() ? get_color(Color::eSelected) : signalColor) };
+  QColor const notActive{ (isSelected() ? get_color(Color::eSelected) : signalColor()) };
   QColor const hover{ get_color(Color::eSocketHover) };
 
   QPen pen{ (m_isHover ? hover : notActive) };
   pen.setStyle((m_to ? Qt::SolidLine : Qt::DashDotLine));
   pen.setWidth(2);
 
-  if (m_valueType != ValueType::eBool) {
-    QPen dash = pen;
-    QColor hover2 = signalColor;
-    hover2.setAlpha(85);
-    dash.setColor(hover2);
-    dash.setStyle(Qt::DotLine);
-    dash.setWidth(6);
-    dash.setDashOffset(m_dashOffset);
-    a_painter->setPen(dash);
-    a_painter->drawPath(m_path);
-  }
-
+  // The dash overlay is drawn by the view's LinkLayer together with all other links.
   a_painter->setPen(pen);
   a_painter->drawPath(m_path);
 }
@@ -98,9 +103,12 @@ void LinkItem::advance(int a_phase)
 {
   if (!a_phase) return;
 
-  if (m_valueType != ValueType::eBool) m_dashOffset -= 0.1;
+  // Only value links animate, a bool link repaints when its signal flips.
+  if (m_valueType == ValueType::eBool) return;
+
+  m_dashOffset = dashOffset();
 
-  update();
+  if (m_layer) m_layer->invalidate(sceneBoundingRect());
 }
 
 void LinkItem::setFrom(SocketItem *const a_from)
@@ -144,6 +152,7 @@ void LinkItem::setColors(QColor const a_signalOff, QColor const a_signalOn)
 
 void LinkItem::setSignal(bool const a_signal)
 {
+  if (a_signal != m_isSignalOn) update();
   m_isSignalOn = a_signal;
 
   if (m_to) m_to->setSignal(a_signal);
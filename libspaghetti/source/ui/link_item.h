@@ -34,6 +34,7 @@ namespace spaghetti {
 
 constexpr int LINK_TYPE{ QGraphicsItem::UserType + 2 };
 
+class LinkLayer;
 class SocketItem;
 
 class LinkItem final : public QGraphicsPathItem {
@@ -67,15 +68,23 @@ class LinkItem final : public QGraphicsPathItem {
 
   bool isSnapped() const { return m_isSnapped; }
   bool isSignalOn() const { return m_isSignalOn; }
+  QColor signalColor() const { return m_isSignalOn ? m_colorSignalOn : m_colorSignalOff; }
+
+  QPainterPath const &linkPath() const { return m_path; }
+  qreal dashOffset() const { return m_dashOffset; }
 
   void trackNodes();
 
+  LinkLayer *layer() const { return m_layer; }
+  void setLayer(LinkLayer *const a_layer) { m_layer = a_layer; }
+
   template<typename... Args>
   void consoleAppendF(const std::string& format, Args ... args);
 
  private:
   SocketItem *m_from{};
   SocketItem *m_to{};
+  LinkLayer *m_layer{};
 
   QRectF m_boundingRect{};
   QPainterPath m_path{};
@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ui/link_layer.h"
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include "spaghetti/socket_item.h"
+#include "ui/link_item.h"
+
+namespace spaghetti {
+
+LinkLayer::LinkLayer(QRectF const &a_rect, QGraphicsItem *a_parent)
+  : QGraphicsItem{ a_parent }
+  , m_boundingRect{ a_rect }
+{
+  setFlag(ItemUsesExtendedStyleOption);
+  setAcceptedMouseButtons(Qt::NoButton);
+  setZValue(-2);
+}
+
+void LinkLayer::paint(QPainter *a_painter, QStyleOptionGraphicsItem const *a_option, QWidget *a_widget)
+{
+  (void)a_widget;
+
+  if (isLowDetail(a_painter)) return;
+
+  auto const LINKS = scene()->items(a_option->exposedRect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder);
+
+  QPen dash{};
+  dash.setStyle(Qt::DotLine);
+  dash.setWidth(6);
+
+  // Links advanced in the same frame share color and offset, so the pen only changes between groups.
+  QColor color{};
+  qreal offset{};
+  bool hasPen{};
+
+  for (auto const item : LINKS) {
+    if (item->type() != LINK_TYPE) continue;
+
+    auto const link = static_cast<LinkItem *>(item);
+    if (link->valueType() == ValueType::eBool) continue;
+
+    QColor linkColor{ link->signalColor() };
+    linkColor.setAlpha(85);
+    qreal const LINK_OFFSET{ link->dashOffset() };
+
+    if (!hasPen || linkColor != color || LINK_OFFSET != offset) {
+      color = linkColor;
+      offset = LINK_OFFSET;
+      hasPen = true;
+      dash.setColor(color);
+      dash.setDashOffset(offset);
+      a_painter->setPen(dash);
+    }
+
+    QPointF const POSITION{ link->pos() };
+    a_painter->translate(POSITION);
+    a_painter->drawPath(link->linkPath());
+    a_painter->translate(-POSITION);
+  }
+}
+
+void LinkLayer::flush()
+{
+  if (m_dirty.isNull()) return;
+
+  update(m_dirty);
+  m_dirty = QRectF{};
+}
+
+} // namespace spaghetti
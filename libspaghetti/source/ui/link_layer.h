@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef UI_LINK_LAYER_H
+#define UI_LINK_LAYER_H
+
+#include <QGraphicsItem>
+
+namespace spaghetti {
+
+constexpr int LINK_LAYER_TYPE{ QGraphicsItem::UserType + 4 };
+
+// Draws the animated dash overlay of every value link in a single pass. Links only report where their
+// dashes moved, and the layer repaints the union of those areas once per frame.
+class LinkLayer final : public QGraphicsItem {
+ public:
+  explicit LinkLayer(QRectF const &a_rect, QGraphicsItem *a_parent = nullptr);
+
+  int type() const override { return LINK_LAYER_TYPE; }
+
+  QRectF boundingRect() const override { return m_boundingRect; }
+  QPainterPath shape() const override { return QPainterPath{}; }
+
+  void paint(QPainter *a_painter, QStyleOptionGraphicsItem const *a_option, QWidget *a_widget) override;
+
+  void invalidate(QRectF const &a_rect) { m_dirty |= a_rect; }
+  void flush();
+
+ private:
+  QRectF const m_boundingRect{};
+  QRectF m_dirty{};
+};
+
+} // namespace spaghetti
+
+#endif // UI_LINK_LAYER_H
@@ -22,16 +22,22 @@
 
 #include "ui/package_view.h"
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QDragEnterEvent>
 #include <QDragLeaveEvent>
 #include <QDragMoveEvent>
 #include <QGraphicsScene>
+#include <QGuiApplication>
 #include <QHeaderView>
 #include <QMimeData>
+#include <QPixmap>
+#include <QScreen>
 #include <QSortFilterProxyModel>
 #include <QTableWidget>
 #include <QTimeLine>
+#include <QtMath>
 
 #include "spaghetti/logger.h"
 
@@ -43,14 +49,20 @@
 
 #include "spaghetti/editor.h"
 #include "spaghetti/node.h"
+#include "spaghetti/node_registry.h"
 #include "spaghetti/package.h"
 #include "spaghetti/registry.h"
 #include "ui/elements_list.h"
 #include "ui/link_item.h"
+#include "ui/link_layer.h"
 #include "nodes/package.h"
 
 namespace spaghetti {
 
+namespace {
+int const MAX_REFRESH_RATE{ 60 };
+} // namespace
+
 NodesListModel::NodesListModel(QObject *const a_parent)
   : QAbstractListModel{ a_parent }
 {
@@ -122,7 +134,7 @@ PackageView::PackageView(Editor *const a_editor, Package *const a_package)
   , m_standalone{ m_package->package() == nullptr }
 {
   if (m_standalone) {
-    m_packageNode = static_cast<nodes::Package *>(/*Registry::get()*/m_editor->RegistryGet().createNode("logic/package"));
+    m_packageNode = static_cast<nodes::Package *>(NodeRegistry::get().createNode(Package::HASH));
     m_package->setNode(m_packageNode);
   } else
     m_packageNode = m_package->node<nodes::Package>();
@@ -131,8 +143,10 @@ PackageView::PackageView(Editor *const a_editor, Package *const a_package)
   QGLFormat format{ QGL::DoubleBuffer | QGL::SampleBuffers | QGL::DirectRendering };
   format.setProfile(QGLFormat::CoreProfile);
   setViewport(new QGLWidget{ QGLFormat{ format } });
-#endif
   setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+#else
+  setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+#endif
   setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::HighQualityAntialiasing |
                  QPainter::SmoothPixmapTransform);
   setDragMode(QGraphicsView::ScrollHandDrag);
@@ -146,9 +160,11 @@ PackageView::PackageView(Editor *const a_editor, Package *const a_package)
 
   m_nodesProxyModel->setSourceModel(m_nodesModel);
 
-  m_scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+  // Qt keeps the tree up to date while items move, so hit-testing and exposed-area painting stay logarithmic.
+  m_scene->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
   m_scene->setSceneRect(-32000, -32000, 64000, 64000);
   m_scene->setObjectName("PackageViewScene");
+  m_linkLayer = new LinkLayer{ m_scene->sceneRect() };
 
   QBrush brush{ QColor(169, 169, 169, 32) };
   m_scene->setBackgroundBrush(brush);
@@ -185,13 +201,17 @@ PackageView::PackageView(Editor *const a_editor, Package *const a_package)
 
   m_scene->addItem(m_inputs);
   m_scene->addItem(m_outputs);
+  m_scene->addItem(m_linkLayer);
 
-  //m_timer.setInterval(1000 / 60);
-  //m_timer.setInterval(5000);
-  m_timer.setInterval(1);
+  // Follow the display, there is no point in refreshing faster than it can show.
+  auto const screen = QGuiApplication::primaryScreen();
+  int const SCREEN_RATE{ screen ? qRound(screen->refreshRate()) : 0 };
+  setRefreshRate(SCREEN_RATE > 0 ? qMin(SCREEN_RATE, MAX_REFRESH_RATE) : MAX_REFRESH_RATE);
+  m_timer.setTimerType(Qt::PreciseTimer);
 
-  connect(&m_timer, &QTimer::timeout, [this]() { m_scene->advance(); });
-  m_timer.start();
+  m_snapshots = m_package->subscribeSnapshots();
+
+  connect(&m_timer, &QTimer::timeout, [this]() { refresh(); });
 
   if (m_standalone) m_package->startDispatchThread();
 }
@@ -199,12 +219,99 @@ PackageView::PackageView(Editor *const a_editor, Package *const a_package)
 PackageView::~PackageView()
 {
   m_timer.stop();
+  m_package->unsubscribeSnapshots(m_snapshots);
   if (m_standalone) {
     m_package->quitDispatchThread();
     delete m_package;
   }
 }
 
+void PackageView::setRefreshRate(int const a_framesPerSecond)
+{
+  assert(a_framesPerSecond > 0);
+  m_refreshRate = a_framesPerSecond;
+  m_timer.setInterval(1000 / m_refreshRate);
+}
+
+void PackageView::showEvent(QShowEvent *a_event)
+{
+  m_timer.start();
+  QGraphicsView::showEvent(a_event);
+}
+
+void PackageView::hideEvent(QHideEvent *a_event)
+{
+  m_timer.stop();
+  QGraphicsView::hideEvent(a_event);
+}
+
+void PackageView::refresh()
+{
+  // Nothing ticked since the last frame, so nothing shown can have changed either.
+  if (!m_snapshots->acquire()) return;
+
+  auto const &SNAPSHOT = m_snapshots->front();
+  if (SNAPSHOT.layout != m_observedLayout) {
+    observeSignals();
+    m_observedLayout = SNAPSHOT.layout;
+
+    m_inputs->refreshSignals();
+    m_outputs->refreshSignals();
+    for (auto const node : m_nodes) node->refreshSignals();
+    m_linkLayer->flush();
+    return;
+  }
+
+  m_changedNodes.clear();
+  for (auto const HANDLE : SNAPSHOT.changes) {
+    auto const IT = m_observers.constFind(HANDLE.key());
+    if (IT != m_observers.cend()) m_changedNodes += IT.value();
+  }
+
+  std::sort(std::begin(m_changedNodes), std::end(m_changedNodes));
+  m_changedNodes.erase(std::unique(std::begin(m_changedNodes), std::end(m_changedNodes)), std::end(m_changedNodes));
+  for (auto const node : m_changedNodes) node->refreshSignals();
+  m_linkLayer->flush();
+}
+
+void PackageView::observeSignals()
+{
+  m_observers.clear();
+
+  // Same resolution as Node::signal(), against the snapshot whose layout is being observed.
+  auto const &SNAPSHOT = m_snapshots->front();
+  QVector<uint64_t> keys{};
+  auto const observe = [&SNAPSHOT, &keys](Node *const a_node) {
+    auto const element = a_node->element();
+    if (!element) return;
+
+    // Inputs may alias the driving output's signal unless the value gets copied.
+    keys.clear();
+    auto const add = [&SNAPSHOT, &keys](Element::IOSocket const &a_socket) {
+      keys << SNAPSHOT.resolve(a_socket.storage).key() << a_socket.storage.key();
+    };
+    for (auto const &SOCKET : element->inputs()) add(SOCKET);
+    for (auto const &SOCKET : element->outputs()) add(SOCKET);
+    std::sort(std::begin(keys), std::end(keys));
+    keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+
+    for (auto const KEY : keys) m_observers[KEY].append(a_node);
+  };
+
+  // Socket lists only change between ticks.
+  m_package->pauseDispatchThread();
+  observe(m_inputs);
+  observe(m_outputs);
+  for (auto const node : m_nodes) observe(node);
+  m_package->resumeDispatchThread();
+}
+
+SnapshotBuffer::Snapshot const *PackageView::snapshot() const
+{
+  auto const &SNAPSHOT = m_snapshots->front();
+  return SNAPSHOT.tick ? &SNAPSHOT : nullptr;
+}
+
 void PackageView::open()
 {
   auto const &inputsPosition = m_package->inputsPosition();
@@ -214,11 +321,8 @@ void PackageView::open()
 
   Registry &registry{ /*Registry::get()*/m_editor->RegistryGet() };
 
-  auto const &elements = m_package->elements();
-  size_t const SIZE{ elements.size() };
-  for (size_t i = 1; i < SIZE; ++i) {
-    auto const element = elements[i];
-    auto const node = registry.createNode(element->hash());
+  for (auto const element : m_package->elements()) {
+    auto const node = NodeRegistry::get().createNode(element->hash());
     auto const nodeName = QString::fromStdString(registry.elementName(element->hash()));
     auto const nodeIcon = QString::fromStdString(registry.elementIcon(element->hash()));
     auto const nodePath = QString::fromLocal8Bit(element->type());
@@ -263,6 +367,8 @@ void PackageView::open()
     auto const targetSocket =  targetIos[TARGET_SOCKET];
     sourceSocket->connect(targetSocket);
   }
+
+  m_observedLayout = 0;
 }
 
 void PackageView::save()
@@ -290,10 +396,8 @@ void PackageView::dragEnterEvent(QDragEnterEvent *a_event)
 
     auto const DROP_POSITION = mapToScene(a_event->pos());
 
-    Registry &registry{ /*Registry::get()*/m_editor->RegistryGet() };
-
     assert(m_dragNode == nullptr);
-    m_dragNode = registry.createNode(path);
+    m_dragNode = NodeRegistry::get().createNode(path);
     m_dragNode->setPackageView(this);
     m_dragNode->setPropertiesTable(m_properties);
     m_dragNode->setName(name);
@@ -428,34 +532,45 @@ void PackageView::wheelEvent(QWheelEvent *a_event)
 
 void PackageView::drawBackground(QPainter *a_painter, QRectF const &a_rect)
 {
-  QPen penNormal{ QColor(156, 156, 156, 32) };
-  QPen penAxis{ QColor(156, 156, 156, 128) };
-
-  qreal const LEFT{ a_rect.left() };
-  qreal const RIGHT{ a_rect.right() };
-  qreal const TOP{ a_rect.top() };
-  qreal const BOTTOM{ a_rect.bottom() };
   qreal const GRID_DENSITY{ (m_gridDensity == GridDensity::eSmall ? 100.0 : 10.0) };
+  qreal const SCALE{ matrix().m11() };
+  if (m_gridTile.isNull() || !qFuzzyCompare(m_gridTileScale, SCALE)) renderGridTile(GRID_DENSITY, SCALE);
 
-  qreal const START_X{ std::round(LEFT / GRID_DENSITY) * GRID_DENSITY };
-  qreal const START_Y{ std::round(TOP / GRID_DENSITY) * GRID_DENSITY };
+  // A texture brush tiles from the scene origin, so one fill covers the whole exposed area.
+  QBrush brush{ m_gridTile };
+  brush.setTransform(QTransform::fromScale(GRID_DENSITY / m_gridTile.width(), GRID_DENSITY / m_gridTile.height()));
+  a_painter->fillRect(a_rect, brush);
 
-  if (m_gridDensity == GridDensity::eSmall) {
-    penAxis.setWidth(2);
-    penNormal.setWidth(2);
-  }
+  QPen penAxis{ QColor(156, 156, 156, 128) };
+  if (m_gridDensity == GridDensity::eSmall) penAxis.setWidth(2);
+  a_painter->setPen(penAxis);
 
-  for (qreal x = START_X; x < RIGHT; x += GRID_DENSITY) {
-    QPen const PEN{ ((x >= -0.1 && x <= 0.1) ? penAxis : penNormal) };
-    a_painter->setPen(PEN);
-    a_painter->drawLine(QPointF{ x, TOP }, QPointF{ x, BOTTOM });
-  }
+  if (a_rect.left() <= 0.0 && a_rect.right() >= 0.0)
+    a_painter->drawLine(QPointF{ 0.0, a_rect.top() }, QPointF{ 0.0, a_rect.bottom() });
+  if (a_rect.top() <= 0.0 && a_rect.bottom() >= 0.0)
+    a_painter->drawLine(QPointF{ a_rect.left(), 0.0 }, QPointF{ a_rect.right(), 0.0 });
+}
 
-  for (qreal y = START_Y; y < BOTTOM; y += GRID_DENSITY) {
-    QPen const PEN{ ((y >= -0.1 && y <= 0.1) ? penAxis : penNormal) };
-    a_painter->setPen(PEN);
-    a_painter->drawLine(QPointF{ LEFT, y }, QPointF{ RIGHT, y });
-  }
+void PackageView::renderGridTile(qreal const a_density, qreal const a_scale)
+{
+  int const SIZE{ qMax(1, qCeil(a_density * a_scale)) };
+
+  m_gridTile = QPixmap{ SIZE, SIZE };
+  m_gridTile.fill(Qt::transparent);
+  m_gridTileScale = a_scale;
+
+  QPen penNormal{ QColor(156, 156, 156, 32) };
+  if (m_gridDensity == GridDensity::eSmall) penNormal.setWidth(2);
+
+  // Lines sit on the tile's edges, each edge holding its half so neighbouring tiles join them up.
+  QPainter painter{ &m_gridTile };
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.scale(SIZE / a_density, SIZE / a_density);
+  painter.setPen(penNormal);
+  painter.drawLine(QPointF{ 0.0, 0.0 }, QPointF{ 0.0, a_density });
+  painter.drawLine(QPointF{ a_density, 0.0 }, QPointF{ a_density, a_density });
+  painter.drawLine(QPointF{ 0.0, 0.0 }, QPointF{ a_density, 0.0 });
+  painter.drawLine(QPointF{ 0.0, a_density }, QPointF{ a_density, a_density });
 }
 
 void PackageView::cancelDragLink()
@@ -493,6 +608,10 @@ void PackageView::deleteElement()
     // empty
   }
 
+  // Some of the observed nodes are about to go away.
+  m_observers.clear();
+  m_observedLayout = 0;
+
   for (auto &&item : selectedItems) {
     switch (item->type()) {
       case NODE_TYPE: {
@@ -517,7 +636,7 @@ void PackageView::deleteElement()
     }
   }
 
-  m_timer.start();
+  if (isVisible()) m_timer.start();
   showProperties();
 }
 
@@ -558,6 +677,7 @@ void PackageView::updateGrid(qreal const a_scale)
   if (newDensity == m_gridDensity) return;
 
   m_gridDensity = newDensity;
+  m_gridTile = QPixmap{};
 }
 
 void PackageView::consoleAppend(char* text){
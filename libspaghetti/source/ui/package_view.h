@@ -27,8 +27,13 @@
 #include <QAbstractListModel>
 #include <QGraphicsView>
 #include <QHash>
+#include <QPixmap>
 #include <QTimer>
 
+#include <memory>
+
+#include <spaghetti/snapshot_buffer.h>
+
 class QTableWidget;
 class QListView;
 class QSortFilterProxyModel;
@@ -42,6 +47,7 @@ class Package;
 class Package;
 class Node;
 class LinkItem;
+class LinkLayer;
 class Editor;
 
 class NodesListModel : public QAbstractListModel {
@@ -86,6 +92,8 @@ class PackageView final : public QGraphicsView {
   void wheelEvent(QWheelEvent *a_event) override;
   void drawBackground(QPainter *painter, QRectF const &a_rect) override;
 
+  LinkLayer *linkLayer() const { return m_linkLayer; }
+
   LinkItem *dragLink() const { return m_dragLink; }
   void setDragLink(LinkItem *a_link) { m_dragLink = a_link; }
   void acceptDragLink() { m_dragLink = nullptr; }
@@ -98,6 +106,8 @@ class PackageView final : public QGraphicsView {
   Package *package() { return m_package; }
   Package *graph() { return m_package; }
 
+  SnapshotBuffer::Snapshot const *snapshot() const;
+
   bool canClose();
   void center();
   bool snapToGrid() const { return m_snapToGrid; }
@@ -122,11 +132,22 @@ class PackageView final : public QGraphicsView {
 
   void setSelectedNode(Node *const a_node);
 
+  // How often a visible view picks up new signal values, hidden views don't refresh at all.
+  void setRefreshRate(int const a_framesPerSecond);
+  int refreshRate() const { return m_refreshRate; }
+
+ protected:
+  void showEvent(QShowEvent *a_event) override;
+  void hideEvent(QHideEvent *a_event) override;
+
  signals:
   void requestOpenFile(QString const a_filename);
 
  private:
   void updateGrid(qreal const a_scale);
+  void renderGridTile(qreal const a_density, qreal const a_scale);
+  void refresh();
+  void observeSignals();
 
  private:
   Editor *const m_editor{};
@@ -138,14 +159,23 @@ class PackageView final : public QGraphicsView {
   Nodes m_nodes{};
   QGraphicsScene *const m_scene{};
   QTimer m_timer{};
+  int m_refreshRate{};
+  std::shared_ptr<SnapshotBuffer> m_snapshots{};
+  // Nodes showing each signal, keyed by SignalStore::Handle::key() and rebuilt whenever the layout changes.
+  QHash<uint64_t, QVector<Node *>> m_observers{};
+  uint64_t m_observedLayout{};
+  QVector<Node *> m_changedNodes{};
   Node *const m_inputs{};
   Node *const m_outputs{};
+  LinkLayer *m_linkLayer{};
   nodes::Package *m_packageNode{};
   Node *m_dragNode{};
   Node *m_selectedNode{};
   LinkItem *m_dragLink{};
   int32_t m_scheduledScalings{};
   enum class GridDensity { eLarge, eSmall } m_gridDensity{};
+  QPixmap m_gridTile{};
+  qreal m_gridTileScale{};
   QString m_filename{};
   bool m_snapToGrid{};
   bool m_standalone{};
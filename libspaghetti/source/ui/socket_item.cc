@@ -103,6 +103,13 @@ void SocketItem::paint(QPainter *a_painter, QStyleOptionGraphicsItem const *a_op
   }
 
 
+  if (isLowDetail(a_painter)) {
+    a_painter->setPen(Qt::NoPen);
+    a_painter->setBrush(brush);
+    a_painter->drawRect(rect);
+    return;
+  }
+
   a_painter->setPen(pen);
   a_painter->setBrush(brush);
   if (m_type == Type::eOutput) {
@@ -251,6 +258,7 @@ void SocketItem::mouseMoveEvent(QGraphicsSceneMouseEvent *a_event)
   auto linkItem = new LinkItem;
   linkItem->setColors(m_colorSignalOff, m_colorSignalOn);
   linkItem->setValueType(m_valueType);
+  if (auto const view = m_node->packageView()) linkItem->setLayer(view->linkLayer());
   linkItem->setFrom(this);
   linkItem->setSignal(m_isSignalOn);
 
@@ -308,6 +316,7 @@ void SocketItem::setColors(QColor const a_signalOff, QColor const a_signalOn)
 void SocketItem::setSignal(bool const a_signal)
 {
   bool delta = a_signal != m_isSignalOn;
+  if (delta) update();
   delta = delta || (m_isSignalOn != m_isSignalOnPrev);
   m_isSignalOnPrev = m_isSignalOn;
   m_isSignalOn = a_signal;
@@ -316,11 +325,17 @@ void SocketItem::setSignal(bool const a_signal)
     for (LinkItem *const link : m_links) link->setSignal(a_signal);
 }
 
+void SocketItem::animateLinks()
+{
+  for (auto const link : m_links) link->advance(1);
+}
+
 void SocketItem::connect(SocketItem *const a_other)
 {
   auto const linkItem = new LinkItem;
   linkItem->setColors(m_colorSignalOff, m_colorSignalOn);
   linkItem->setValueType(m_valueType);
+  if (auto const view = m_node->packageView()) linkItem->setLayer(view->linkLayer());
   linkItem->setFrom(this);
   linkItem->setTo(a_other);
 
@@ -0,0 +1,112 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "worker_pool.h"
+
+#include <cassert>
+
+#include "spaghetti/logger.h"
+
+namespace spaghetti {
+
+namespace {
+// Levels of one tick follow each other closely, so helpers poll for a while before falling asleep.
+constexpr size_t const SPIN_COUNT{ 256 };
+} // namespace
+
+WorkerPool::WorkerPool(size_t const a_participants)
+  : m_participants{ a_participants }
+  , m_slices{ std::make_unique<Slice[]>(a_participants) }
+{
+  assert(a_participants > 0);
+
+  spaghetti::log::debug("Starting {} worker helper threads..", m_participants - 1);
+
+  for (size_t i = 1; i < m_participants; ++i) m_helpers.emplace_back(&WorkerPool::helperThreadFunction, this, i);
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_quit = true;
+  }
+  m_wake.notify_all();
+
+  for (auto &helper : m_helpers) helper.join();
+}
+
+void WorkerPool::dispatch(size_t const a_count)
+{
+  if (a_count == 0) return;
+
+  for (size_t i = 0; i < m_participants; ++i) {
+    m_slices[i].next = a_count * i / m_participants;
+    m_slices[i].end = a_count * (i + 1) / m_participants;
+  }
+
+  if (m_helpers.empty()) {
+    work(0);
+    return;
+  }
+
+  m_busyHelpers = m_helpers.size();
+  {
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    m_generation++;
+  }
+  m_wake.notify_all();
+
+  work(0);
+
+  while (m_busyHelpers != 0) std::this_thread::yield();
+}
+
+void WorkerPool::work(size_t const a_participant)
+{
+  for (size_t i = 0; i < m_participants; ++i) {
+    auto &slice = m_slices[(a_participant + i) % m_participants];
+    for (size_t index = slice.next++; index < slice.end; index = slice.next++) m_job(m_jobData, index);
+  }
+}
+
+void WorkerPool::helperThreadFunction(size_t const a_participant)
+{
+  uint64_t seen{};
+
+  while (true) {
+    for (size_t spin = 0; spin < SPIN_COUNT && m_generation == seen && !m_quit; ++spin) std::this_thread::yield();
+
+    if (m_generation == seen && !m_quit) {
+      std::unique_lock<std::mutex> lock{ m_mutex };
+      m_wake.wait(lock, [this, seen] { return m_quit || m_generation != seen; });
+    }
+
+    if (m_quit) return;
+
+    seen = m_generation;
+    work(a_participant);
+    m_busyHelpers--;
+  }
+}
+
+} // namespace spaghetti
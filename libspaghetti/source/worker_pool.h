@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+#ifndef SPAGHETTI_WORKER_POOL_H
+#define SPAGHETTI_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spaghetti {
+
+// Runs batches of independent jobs on the calling thread plus a set of helper threads. Every participant
+// starts on its own slice of the batch and steals from the others once it runs dry; run() returns only
+// after the whole batch is done, which makes each call a barrier.
+class WorkerPool final {
+ public:
+  explicit WorkerPool(size_t const a_participants);
+  ~WorkerPool();
+
+  size_t participants() const { return m_participants; }
+
+  template<typename Job>
+  void run(size_t const a_count, Job const &a_job)
+  {
+    m_job = [](void const *const a_data, size_t const a_index) { (*static_cast<Job const *>(a_data))(a_index); };
+    m_jobData = &a_job;
+    dispatch(a_count);
+  }
+
+ private:
+  struct alignas(64) Slice {
+    std::atomic_size_t next{};
+    size_t end{};
+  };
+
+  void dispatch(size_t const a_count);
+  void work(size_t const a_participant);
+  void helperThreadFunction(size_t const a_participant);
+
+ private:
+  size_t const m_participants{};
+  std::unique_ptr<Slice[]> m_slices{};
+  std::vector<std::thread> m_helpers{};
+
+  void (*m_job)(void const *, size_t){};
+  void const *m_jobData{};
+
+  std::mutex m_mutex{};
+  std::condition_variable m_wake{};
+  std::atomic_uint64_t m_generation{};
+  std::atomic_size_t m_busyHelpers{};
+  std::atomic_bool m_quit{};
+};
+
+} // namespace spaghetti
+
+#endif // SPAGHETTI_WORKER_POOL_H
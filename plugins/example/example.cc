@@ -25,7 +25,6 @@
 
 #include "spaghetti/element.h"
 #include "spaghetti/logger.h"
-#include "spaghetti/node.h"
 #include "spaghetti/registry.h"
 
 class Example final : public spaghetti::Element {
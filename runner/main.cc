@@ -0,0 +1,298 @@
+// MIT License
+//
+// Copyright (c) 2017-2018 Artur Wyszyński, aljen at hitomi dot pl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <clocale>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <spaghetti/binary_package.h>
+#include <spaghetti/logger.h>
+#include <spaghetti/package.h>
+#include <spaghetti/registry.h>
+
+namespace {
+
+using spaghetti::BinaryPackage;
+using spaghetti::Element;
+using spaghetti::Package;
+
+struct Options {
+  std::string filename{};
+  std::string convertTo{};
+  uint64_t ticks{ 1000 };
+  double deltaMs{ 1.0 };
+  uint64_t every{};
+  size_t threads{};
+  bool dirtyOnly{};
+  bool zeroCopy{};
+  bool flatten{};
+  bool verbose{};
+  std::vector<std::string> dumps{};
+};
+
+struct Probe {
+  std::string label{};
+  Element *element{};
+  size_t socket{};
+};
+
+void printUsage(char const *const a_name)
+{
+  std::cerr << "Usage: " << a_name << " [options] <file.package>\n"
+            << "  --ticks N        number of ticks to run (default 1000)\n"
+            << "  --delta MS       virtual time advanced every tick in milliseconds (default 1)\n"
+            << "  --dump E:S       print output S of element E, both given by id or name (repeatable),\n"
+            << "                   defaults to all outputs of the package itself\n"
+            << "  --every N        print a row every N ticks instead of only after the last one\n"
+            << "  --dirty-only     evaluate only elements whose inputs changed\n"
+            << "  --zero-copy      alias connected inputs to their driving outputs\n"
+            << "  --flatten        inline nested packages into the top level schedule\n"
+            << "  --threads N      run package levels on N threads\n"
+            << "  --verbose        keep library logging, it shares stdout with the dump otherwise\n"
+            << "  --convert FILE   write the package to FILE instead of running it, as binary when FILE\n"
+            << "                   ends with " << BinaryPackage::EXTENSION << " and as JSON otherwise\n";
+}
+
+bool parseOptions(int const a_argc, char **const a_argv, Options &a_options)
+{
+  for (int i = 1; i < a_argc; ++i) {
+    std::string const ARG{ a_argv[i] };
+    bool const HAS_VALUE{ i + 1 < a_argc };
+
+    if (ARG == "--ticks" && HAS_VALUE)
+      a_options.ticks = std::strtoull(a_argv[++i], nullptr, 10);
+    else if (ARG == "--delta" && HAS_VALUE)
+      a_options.deltaMs = std::strtod(a_argv[++i], nullptr);
+    else if (ARG == "--dump" && HAS_VALUE)
+      a_options.dumps.emplace_back(a_argv[++i]);
+    else if (ARG == "--every" && HAS_VALUE)
+      a_options.every = std::strtoull(a_argv[++i], nullptr, 10);
+    else if (ARG == "--convert" && HAS_VALUE)
+      a_options.convertTo = a_argv[++i];
+    else if (ARG == "--threads" && HAS_VALUE)
+      a_options.threads = std::strtoull(a_argv[++i], nullptr, 10);
+    else if (ARG == "--dirty-only")
+      a_options.dirtyOnly = true;
+    else if (ARG == "--zero-copy")
+      a_options.zeroCopy = true;
+    else if (ARG == "--flatten")
+      a_options.flatten = true;
+    else if (ARG == "--verbose")
+      a_options.verbose = true;
+    else if (ARG.empty() || ARG[0] == '-' || !a_options.filename.empty())
+      return false;
+    else
+      a_options.filename = ARG;
+  }
+
+  return !a_options.filename.empty();
+}
+
+bool endsWith(std::string const &a_string, std::string const &a_suffix)
+{
+  return a_string.size() >= a_suffix.size() &&
+         a_string.compare(a_string.size() - a_suffix.size(), a_suffix.size(), a_suffix) == 0;
+}
+
+// Converts on the file level, so nothing an element stored gets lost on the way.
+bool convert(std::string const &a_from, std::string const &a_to)
+{
+  BinaryPackage::Json json{};
+
+  if (BinaryPackage::isBinary(a_from)) {
+    BinaryPackage const FILE{ a_from };
+    if (!FILE.isValid()) return false;
+    json = FILE.toJson();
+  } else {
+    std::ifstream file{ a_from };
+    if (!file.is_open()) return false;
+    json = BinaryPackage::Json::parse(file, nullptr, false);
+    if (json.is_discarded()) return false;
+  }
+
+  if (endsWith(a_to, BinaryPackage::EXTENSION)) return BinaryPackage::write(json, a_to);
+
+  std::ofstream file{ a_to };
+  file << json.dump(2);
+  return file.good();
+}
+
+bool isNumber(std::string const &a_string)
+{
+  return !a_string.empty() && a_string.find_first_not_of("0123456789") == std::string::npos;
+}
+
+Element *findElement(Package const &a_package, std::string const &a_key)
+{
+  if (isNumber(a_key)) {
+    size_t const ID{ std::stoul(a_key) };
+    return a_package.contains(ID) ? a_package.get(ID) : nullptr;
+  }
+
+  for (auto const element : a_package.elements())
+    if (element->name() == a_key) return element;
+
+  return nullptr;
+}
+
+bool findSocket(Element const *const a_element, std::string const &a_key, size_t &a_socket)
+{
+  auto const &OUTPUTS = a_element->outputs();
+
+  if (isNumber(a_key)) {
+    a_socket = std::stoul(a_key);
+    return a_socket < OUTPUTS.size();
+  }
+
+  for (size_t i = 0; i < OUTPUTS.size(); ++i) {
+    if (OUTPUTS[i].name != a_key) continue;
+    a_socket = i;
+    return true;
+  }
+
+  return false;
+}
+
+bool createProbes(Package &a_package, std::vector<std::string> const &a_dumps, std::vector<Probe> &a_probes)
+{
+  if (a_dumps.empty()) {
+    auto const &OUTPUTS = a_package.outputs();
+    for (size_t i = 0; i < OUTPUTS.size(); ++i) a_probes.push_back(Probe{ OUTPUTS[i].name, &a_package, i });
+    return true;
+  }
+
+  for (auto const &DUMP : a_dumps) {
+    auto const SEPARATOR = DUMP.rfind(':');
+    if (SEPARATOR == std::string::npos) {
+      std::cerr << "Invalid dump '" << DUMP << "', expected <element>:<socket>\n";
+      return false;
+    }
+
+    auto const element = findElement(a_package, DUMP.substr(0, SEPARATOR));
+    if (!element) {
+      std::cerr << "No element matching '" << DUMP << "'\n";
+      return false;
+    }
+
+    size_t socket{};
+    if (!findSocket(element, DUMP.substr(SEPARATOR + 1), socket)) {
+      std::cerr << "No output socket matching '" << DUMP << "'\n";
+      return false;
+    }
+
+    a_probes.push_back(Probe{ DUMP, element, socket });
+  }
+
+  return true;
+}
+
+void printValue(Element::Value const &a_value)
+{
+  switch (a_value.index()) {
+    case 0: std::cout << (std::get<bool>(a_value) ? 1 : 0); break;
+    case 1: std::cout << std::get<int32_t>(a_value); break;
+    case 2: std::cout << std::get<float>(a_value); break;
+    case 3: std::cout << static_cast<uint32_t>(std::get<uint8_t>(a_value)); break;
+    case 4: std::cout << std::get<uint64_t>(a_value); break;
+  }
+}
+
+void printHeader(std::vector<Probe> const &a_probes)
+{
+  std::cout << "tick";
+  for (auto const &PROBE : a_probes) std::cout << ',' << PROBE.label;
+  std::cout << '\n';
+}
+
+void printRow(uint64_t const a_tick, std::vector<Probe> const &a_probes)
+{
+  std::cout << a_tick;
+  for (auto const &PROBE : a_probes) {
+    std::cout << ',';
+    printValue(PROBE.element->outputs()[PROBE.socket].value());
+  }
+  std::cout << '\n';
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+  Options options{};
+  if (!parseOptions(argc, argv, options)) {
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::setlocale(LC_ALL, "C");
+
+  spaghetti::log::init();
+  if (!options.verbose)
+    for (auto const &LOGGER : spaghetti::log::get()) LOGGER->set_level(spdlog::level::err);
+
+  if (!options.convertTo.empty()) {
+    if (!std::ifstream{ options.filename }.is_open()) {
+      std::cerr << "Unable to open '" << options.filename << "'\n";
+      return EXIT_FAILURE;
+    }
+    if (convert(options.filename, options.convertTo)) return EXIT_SUCCESS;
+
+    std::cerr << "Unable to convert '" << options.filename << "' to '" << options.convertTo << "'\n";
+    return EXIT_FAILURE;
+  }
+
+  auto &registry = spaghetti::Registry::instance();
+  registry.registerInternalElements();
+  registry.loadPlugins();
+  registry.loadPackages();
+
+  Package package{};
+  if (!package.open(options.filename)) {
+    std::cerr << "Unable to open '" << options.filename << "'\n";
+    return EXIT_FAILURE;
+  }
+
+  package.setEvaluationMode(options.dirtyOnly ? Package::EvaluationMode::eDirtyOnly : Package::EvaluationMode::eEveryTick);
+  package.setZeroCopyConnections(options.zeroCopy);
+  package.setFlattenPackages(options.flatten);
+  if (options.threads > 1) package.setWorkerThreads(options.threads);
+
+  std::vector<Probe> probes{};
+  if (!createProbes(package, options.dumps, probes)) return EXIT_FAILURE;
+
+  printHeader(probes);
+
+  // The clock is virtual, every tick advances it by the same delta no matter how long the tick took.
+  Element::duration_t const DELTA{ options.deltaMs };
+
+  for (uint64_t tick = 1; tick <= options.ticks; ++tick) {
+    package.update(DELTA);
+    package.calculate();
+
+    if ((options.every && tick % options.every == 0) || tick == options.ticks) printRow(tick, probes);
+  }
+
+  return EXIT_SUCCESS;
+}